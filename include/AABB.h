@@ -0,0 +1,110 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <limits>
+
+/// Axis-aligned bounding box used by the collision broadphase structures
+/// Plain value type - kept trivially copyable so it can live in contiguous node pools
+struct AABB {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    AABB() = default;
+    AABB(const glm::vec3& minPoint, const glm::vec3& maxPoint)
+        : min(minPoint), max(maxPoint) {}
+
+    /// Check if two boxes overlap (touching counts as overlap)
+    bool overlaps(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    /// Check if this box fully contains another box
+    bool contains(const AABB& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    /// Check if this box contains a point
+    bool contains(const glm::vec3& point) const {
+        return point.x >= min.x && point.x <= max.x &&
+               point.y >= min.y && point.y <= max.y &&
+               point.z >= min.z && point.z <= max.z;
+    }
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extents() const { return (max - min) * 0.5f; }
+
+    /// Surface area - the cost metric for SAH insertion and rebuilds
+    /// Flat 2D boxes (zero depth) degrade to twice their area, which keeps the metric consistent
+    float surfaceArea() const {
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    /// Grow the box uniformly by a margin on every side
+    AABB fattened(float margin) const {
+        return AABB(min - glm::vec3(margin), max + glm::vec3(margin));
+    }
+
+    /// Union of two boxes
+    static AABB merge(const AABB& a, const AABB& b) {
+        return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+    }
+
+    /// Slab test against a ray segment origin + t * dir, t in [0, maxT]
+    /// @param tEnter - entry distance along the ray (0 when the origin is inside)
+    bool intersectRay(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& tEnter) const {
+        float tNear = 0.0f;
+        float tFar = maxT;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (dir[axis] == 0.0f) {
+                // Parallel to the slab - must start inside it
+                if (origin[axis] < min[axis] || origin[axis] > max[axis]) return false;
+                continue;
+            }
+            float inv = 1.0f / dir[axis];
+            float t1 = (min[axis] - origin[axis]) * inv;
+            float t2 = (max[axis] - origin[axis]) * inv;
+            if (t1 > t2) std::swap(t1, t2);
+            tNear = std::max(tNear, t1);
+            tFar = std::min(tFar, t2);
+            if (tNear > tFar) return false;
+        }
+        tEnter = tNear;
+        return true;
+    }
+
+    /// Sweep this box by delta, t in [0, 1], against a stationary box
+    /// @param toi - first time of contact as a fraction of delta
+    /// @param normal - face normal of other at the first contact (points back towards this box)
+    /// @return false when the boxes never touch during the sweep or already overlap at t = 0
+    bool sweep(const glm::vec3& delta, const AABB& other, float& toi, glm::vec3& normal) const {
+        float tNear = -std::numeric_limits<float>::infinity();
+        float tFar = std::numeric_limits<float>::infinity();
+        int entryAxis = -1;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (delta[axis] == 0.0f) {
+                // No motion on this axis - the intervals must already overlap
+                if (max[axis] < other.min[axis] || min[axis] > other.max[axis]) return false;
+                continue;
+            }
+            float inv = 1.0f / delta[axis];
+            float tIn = delta[axis] > 0.0f ? (other.min[axis] - max[axis]) * inv : (other.max[axis] - min[axis]) * inv;
+            float tOut = delta[axis] > 0.0f ? (other.max[axis] - min[axis]) * inv : (other.min[axis] - max[axis]) * inv;
+            if (tIn > tNear) {
+                tNear = tIn;
+                entryAxis = axis;
+            }
+            tFar = std::min(tFar, tOut);
+        }
+        if (entryAxis < 0 || tNear <= 0.0f || tNear > 1.0f || tNear > tFar) return false;
+
+        toi = tNear;
+        normal = glm::vec3(0.0f);
+        normal[entryAxis] = delta[entryAxis] > 0.0f ? -1.0f : 1.0f;
+        return true;
+    }
+};
@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <memory>
 
+class TransformComponent;
+
 /// Collision component for Frostbite architecture (with SOA backend)
 class CollisionComponent : public EntityComponent {
 public:
@@ -15,6 +17,15 @@ public:
     glm::vec3 getBoundingBoxMin() const;
     glm::vec3 getBoundingBoxMax() const;
 
+    // 绑定变换后包围盒按局部空间解释，世界包围盒由 CollisionSystem 批量更新
+    void bindTransform(const std::shared_ptr<TransformComponent>& transform);
+    glm::vec3 getWorldBoundingBoxMin() const;
+    glm::vec3 getWorldBoundingBoxMax() const;
+
+    // 窄相形状（由局部包围盒定义尺寸）
+    void setShape(CollisionShape shape);
+    CollisionShape getShape() const;
+
     void setCollisionLayer(uint32_t layer);
     uint32_t getCollisionLayer() const;
 
@@ -24,6 +35,17 @@ public:
     void setEnabled(bool enable);
     bool isEnabled() const;
 
+    // 休眠状态（由 CollisionSystem 管理，wake() 强制唤醒）
+    bool isSleeping() const;
+    void wake();
+
+    // 连续碰撞检测（高速物体按扫掠包围盒计算碰撞时间，防止穿透薄物体）
+    void setContinuous(bool continuous);
+    bool isContinuous() const;
+
+    // 所属实体同时写入 SOA 存储，查询结果可按槽位 O(1) 映射回实体
+    void setOwner(std::shared_ptr<GameEntity> entity) override;
+
     void onAttach() override;
     void onDetach() override;
 
@@ -31,6 +53,9 @@ public:
     // 获取共享的 SOA 存储（用于批量处理）
     static std::shared_ptr<CollisionDataStorage> getSharedStorage();
 
+    // 获取 SOA 存储槽位索引（与 CollisionSystem 查询结果对应）
+    uint32_t getStorageIndex() const { return static_cast<uint32_t>(storageHandle.index); }
+
 private:
     // 使用 handle 访问 SOA 后端存储
     CollisionDataStorage::HandleID storageHandle;
@@ -1,69 +1,282 @@
 #pragma once
 
+#include "AABB.h"
+#include "AlignedAllocator.h"
+#include "SoaTable.h"
 #include <vector>
+#include <memory>
 #include <glm/glm.hpp>
 #include <cstdint>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+class GameEntity;
+
+// 窄相形状（在 XY 平面内由局部包围盒和世界矩阵导出）
+enum class CollisionShape : uint8_t {
+    Box,        // 旋转后的包围盒（OBB）
+    Circle      // 内切于局部包围盒 XY 投影的圆
+};
+
+// 候选碰撞对（CollisionDataStorage 槽位索引，a < b）
+struct CollisionPair {
+    uint32_t a = 0;
+    uint32_t b = 0;
+};
 
 /**
  * @brief SOA (Structure of Arrays) 存储碰撞数据
- * 
+ *
  * 将碰撞数据按字段分离存储，优化缓存局部性
  * 适用于批量碰撞检测、空间查询等操作
+ *
+ * 包围盒按分量拆分为 6 条通道（minX[]/minY[]/minZ[]/maxX[]/maxY[]/maxZ[]），
+ * 64 字节对齐并填充到 8 的倍数，AVX2 内核一次可测试 8 个包围盒
+ *
+ * 组件设置的是局部包围盒；通道中保存的是世界包围盒（宽相/查询使用）
+ * - 未绑定变换：世界包围盒 = 局部包围盒
+ * - 绑定变换：由 CollisionSystem 的批处理阶段根据世界矩阵重新计算
  */
 class CollisionDataStorage {
 public:
-    struct HandleID {
-        size_t index = 0;
-        bool isValid() const { return index > 0; }
-    };
+    // SIMD 批宽度（AVX2: 8 x float）
+    static constexpr size_t LANE_WIDTH = 8;
+
+    // 未绑定变换（与 TransformDataStorage::INVALID_HANDLE 相同）
+    static constexpr SoaHandle NO_TRANSFORM{};
+
+    // 链表结束标记（变换 -> 槽位反向索引）
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    template<typename T>
+    using LaneVector = std::vector<T, AlignedAllocator<T, 64>>;
+
+    // 与 SoaTable 相同的句柄类型；槽位被树和碰撞对直接引用，因此不做交换删除，
+    // 移除的槽位经 CollisionSystem 清理后按空闲列表复用（generation 递增，旧句柄失效）
+    using HandleID = SoaHandle;
 
     CollisionDataStorage() = default;
 
-    // 分配新的碰撞数据槽位
+    // 分配碰撞数据槽位（优先复用已释放的槽位）
     HandleID allocate() {
+        if (!freeSlots.empty()) {
+            uint32_t index = freeSlots.back();
+            freeSlots.pop_back();
+            resetSlot(index);
+            return HandleID{index, generations[index]};
+        }
+
         HandleID handle;
-        handle.index = boundingBoxMins.size();
-        
-        boundingBoxMins.emplace_back(glm::vec3(0.0f));
-        boundingBoxMaxs.emplace_back(glm::vec3(0.0f));
-        collisionLayers.emplace_back(0);
-        collisionMasks.emplace_back(0xFFFFFFFF);
+        handle.index = static_cast<uint32_t>(count);
+
+        // 通道按 8 个一组增长，填充槽位永远不会命中
+        if (count == minX.size()) {
+            size_t padded = minX.size() + LANE_WIDTH;
+            const float inf = std::numeric_limits<float>::infinity();
+            minX.resize(padded, inf);
+            minY.resize(padded, inf);
+            minZ.resize(padded, inf);
+            maxX.resize(padded, -inf);
+            maxY.resize(padded, -inf);
+            maxZ.resize(padded, -inf);
+            activeLayers.resize(padded, 0);
+            collisionMasks.resize(padded, 0);
+        }
+        ++count;
+
+        setLaneBounds(handle.index, glm::vec3(0.0f), glm::vec3(0.0f));
+        localMins.emplace_back(0.0f);
+        localMaxs.emplace_back(0.0f);
+        transformHandles.push_back(NO_TRANSFORM);
+        nextSlotsOfTransform.push_back(NO_SLOT);
+        owners.emplace_back();
+        seenWorldVersions.push_back(0);
+        boundsStale.push_back(0);
+        mobilityFlags.push_back(1);
+        shapes.push_back(CollisionShape::Box);
+        sleepFlags.push_back(0);
+        sleepTimers.push_back(0.0f);
+        continuousFlags.push_back(0);
+        collisionLayers.emplace_back(1);
+        collisionMasks[handle.index] = 0xFFFFFFFF;
+        activeLayers[handle.index] = 1;
         enabledFlags.emplace_back(true);
-        
+        dirtyFlags.emplace_back(false);
+        generations.push_back(0);
+        markDirty(handle.index);
+
         return handle;
     }
 
-    // 移除碰撞数据（简单实现：设为无效）
+    // 移除碰撞数据：立即禁用并解除变换绑定，句柄失效；
+    // 槽位进入移除列表，CollisionSystem 销毁代理、清理碰撞对后调用 releaseSlot() 才可复用
     void deallocate(HandleID handle) {
-        if (handle.isValid() && handle.index < enabledFlags.size()) {
-            enabledFlags[handle.index] = false;
-        }
+        if (!isAlive(handle)) return;
+        const uint32_t index = handle.index;
+        setEnabled(handle, false);
+        unlinkTransformSlot(index);
+        transformHandles[index] = NO_TRANSFORM;
+        owners[index].reset();
+        ++generations[index];
+        removedSlots.push_back(index);
+    }
+
+    // 句柄是否仍指向存活槽位（移除后旧句柄失效）
+    bool isAlive(HandleID handle) const {
+        return handle.index < count && generations[handle.index] == handle.generation;
+    }
+
+    // 自上次 clearRemovedSlots() 以来移除的槽位（宽相同步时取走）
+    const std::vector<uint32_t>& getRemovedSlots() const { return removedSlots; }
+    void clearRemovedSlots() { removedSlots.clear(); }
+
+    // 代理和碰撞对已清理，槽位交给 allocate() 复用
+    void releaseSlot(uint32_t index) {
+        freeSlots.push_back(index);
     }
 
-    // 获取包围盒最小点
+    // 获取局部包围盒最小点
     glm::vec3 getBoundingBoxMin(HandleID handle) const {
-        return boundingBoxMins[handle.index];
+        return localMins[handle.index];
     }
 
-    // 设置包围盒最小点
+    // 设置局部包围盒最小点
     void setBoundingBoxMin(HandleID handle, const glm::vec3& min) {
-        boundingBoxMins[handle.index] = min;
+        localMins[handle.index] = min;
+        refreshBounds(handle.index);
     }
 
-    // 获取包围盒最大点
+    // 获取局部包围盒最大点
     glm::vec3 getBoundingBoxMax(HandleID handle) const {
-        return boundingBoxMaxs[handle.index];
+        return localMaxs[handle.index];
     }
 
-    // 设置包围盒最大点
+    // 设置局部包围盒最大点
     void setBoundingBoxMax(HandleID handle, const glm::vec3& max) {
-        boundingBoxMaxs[handle.index] = max;
+        localMaxs[handle.index] = max;
+        refreshBounds(handle.index);
     }
 
-    // 设置包围盒（同时设置最小和最大点）
+    // 设置局部包围盒（同时设置最小和最大点）
     void setBoundingBox(HandleID handle, const glm::vec3& min, const glm::vec3& max) {
-        boundingBoxMins[handle.index] = min;
-        boundingBoxMaxs[handle.index] = max;
+        localMins[handle.index] = min;
+        localMaxs[handle.index] = max;
+        refreshBounds(handle.index);
+    }
+
+    // 获取世界包围盒最小点
+    glm::vec3 getWorldBoundingBoxMin(HandleID handle) const {
+        return glm::vec3(minX[handle.index], minY[handle.index], minZ[handle.index]);
+    }
+
+    // 获取世界包围盒最大点
+    glm::vec3 getWorldBoundingBoxMax(HandleID handle) const {
+        return glm::vec3(maxX[handle.index], maxY[handle.index], maxZ[handle.index]);
+    }
+
+    // 绑定变换（TransformDataStorage 句柄），世界包围盒随世界矩阵更新
+    void bindTransform(HandleID handle, SoaHandle transformHandle) {
+        const uint32_t index = handle.index;
+        unlinkTransformSlot(index);
+        transformHandles[index] = transformHandle;
+        if (transformHandle != NO_TRANSFORM) {
+            // 插入该变换的槽位链表头部
+            if (transformFirstSlots.size() <= transformHandle.index) {
+                transformFirstSlots.resize(transformHandle.index + 1, NO_SLOT);
+            }
+            nextSlotsOfTransform[index] = transformFirstSlots[transformHandle.index];
+            transformFirstSlots[transformHandle.index] = index;
+        }
+        refreshBounds(index);
+    }
+
+    // 对绑定到该变换的每个槽位调用 callback(index)（反向索引，O(绑定数)）
+    template<typename Callback>
+    void forEachSlotOfTransform(SoaHandle transformHandle, Callback&& callback) const {
+        if (transformHandle.index >= transformFirstSlots.size()) return;
+        for (uint32_t slot = transformFirstSlots[transformHandle.index]; slot != NO_SLOT;
+             slot = nextSlotsOfTransform[slot]) {
+            // 句柄索引被复用时，旧代的绑定不算
+            if (transformHandles[slot] == transformHandle) {
+                callback(slot);
+            }
+        }
+    }
+
+    // 获取绑定的变换句柄（NO_TRANSFORM 表示未绑定）
+    SoaHandle getTransformHandle(HandleID handle) const {
+        return transformHandles[handle.index];
+    }
+
+    // 设置所属实体（查询结果槽位 -> 实体，O(1)）
+    void setOwner(HandleID handle, std::weak_ptr<GameEntity> owner) {
+        owners[handle.index] = std::move(owner);
+    }
+
+    // 按槽位索引获取所属实体（未设置或已销毁时为空）
+    std::shared_ptr<GameEntity> getOwner(size_t index) const {
+        return owners[index].lock();
+    }
+
+    // 获取移动性（0 = Static，1 = Movable），绑定变换时由 CollisionSystem 从变换同步
+    uint8_t getMobility(HandleID handle) const {
+        return mobilityFlags[handle.index];
+    }
+
+    // 设置移动性，静态与动态碰撞体由 CollisionSystem 放入不同的空间索引
+    void setMobility(HandleID handle, uint8_t mobility) {
+        if (mobilityFlags[handle.index] != mobility) {
+            mobilityFlags[handle.index] = mobility;
+            markDirty(handle.index);
+        }
+    }
+
+    // 获取窄相形状
+    CollisionShape getShape(HandleID handle) const {
+        return shapes[handle.index];
+    }
+
+    // 设置窄相形状（不影响宽相包围盒）
+    void setShape(HandleID handle, CollisionShape shape) {
+        shapes[handle.index] = shape;
+    }
+
+    // 是否休眠（休眠的动态物体不参与刷新和彼此之间的配对）
+    bool isSleeping(HandleID handle) const {
+        return sleepFlags[handle.index] != 0;
+    }
+
+    // 唤醒物体（重置静止计时，CollisionSystem 下一步唤醒其整个休眠岛）
+    void wake(HandleID handle) {
+        sleepTimers[handle.index] = 0.0f;
+        if (sleepFlags[handle.index]) {
+            sleepFlags[handle.index] = 0;
+            markDirty(handle.index);
+        }
+    }
+
+    // 是否启用连续碰撞检测（扫掠包围盒 + 碰撞时间，仅对高速动态物体开启）
+    bool isContinuous(HandleID handle) const {
+        return continuousFlags[handle.index] != 0;
+    }
+
+    // 设置连续碰撞检测标志（不影响宽相包围盒）
+    void setContinuous(HandleID handle, bool continuous) {
+        continuousFlags[handle.index] = continuous ? 1 : 0;
+    }
+
+    // 批处理阶段写入世界包围盒（不入脏列表，调用方负责 markDirty）
+    void writeWorldBounds(size_t index, const glm::vec3& min, const glm::vec3& max) {
+        setLaneBounds(index, min, max);
+    }
+
+    // 按槽位索引读取世界包围盒（批处理/宽相使用）
+    AABB getBounds(size_t index) const {
+        return AABB(glm::vec3(minX[index], minY[index], minZ[index]),
+                    glm::vec3(maxX[index], maxY[index], maxZ[index]));
     }
 
     // 获取碰撞层
@@ -71,9 +284,13 @@ public:
         return collisionLayers[handle.index];
     }
 
-    // 设置碰撞层
+    // 设置碰撞层（入脏列表：缓存的碰撞对需要重新过滤）
     void setCollisionLayer(HandleID handle, uint32_t layer) {
-        collisionLayers[handle.index] = layer;
+        if (collisionLayers[handle.index] != layer) {
+            collisionLayers[handle.index] = layer;
+            activeLayers[handle.index] = enabledFlags[handle.index] ? layer : 0;
+            markDirty(handle.index);
+        }
     }
 
     // 获取碰撞掩码
@@ -81,9 +298,12 @@ public:
         return collisionMasks[handle.index];
     }
 
-    // 设置碰撞掩码
+    // 设置碰撞掩码（入脏列表：缓存的碰撞对需要重新过滤）
     void setCollisionMask(HandleID handle, uint32_t mask) {
-        collisionMasks[handle.index] = mask;
+        if (collisionMasks[handle.index] != mask) {
+            collisionMasks[handle.index] = mask;
+            markDirty(handle.index);
+        }
     }
 
     // 获取启用状态
@@ -93,57 +313,353 @@ public:
 
     // 设置启用状态
     void setEnabled(HandleID handle, bool enabled) {
-        enabledFlags[handle.index] = enabled;
+        if (enabledFlags[handle.index] != enabled) {
+            enabledFlags[handle.index] = enabled;
+            activeLayers[handle.index] = enabled ? collisionLayers[handle.index] : 0;
+            markDirty(handle.index);
+        }
+    }
+
+    // 层/掩码过滤：双方的层都必须在对方的掩码中
+    bool canCollide(size_t a, size_t b) const {
+        return (collisionLayers[a] & collisionMasks[b]) != 0 &&
+               (collisionLayers[b] & collisionMasks[a]) != 0;
+    }
+
+    // === SIMD 批量查询原语 ===
+
+    // 测试 box 与连续 8 个槽位 [first, first + 8) 的重叠（first 须为 8 的倍数）
+    // 同时应用层/掩码过滤，禁用槽位与填充槽位永远不命中
+    // @return 位掩码，bit i 对应槽位 first + i
+    uint32_t overlapMask8(const AABB& box, uint32_t layer, uint32_t mask, size_t first) const {
+#if defined(__AVX2__)
+        __m256 overlap = overlapLanes(box,
+            _mm256_load_ps(&minX[first]), _mm256_load_ps(&minY[first]), _mm256_load_ps(&minZ[first]),
+            _mm256_load_ps(&maxX[first]), _mm256_load_ps(&maxY[first]), _mm256_load_ps(&maxZ[first]));
+        __m256i layers = _mm256_load_si256(reinterpret_cast<const __m256i*>(&activeLayers[first]));
+        __m256i masks = _mm256_load_si256(reinterpret_cast<const __m256i*>(&collisionMasks[first]));
+        return combineFilter(overlap, layers, masks, layer, mask);
+#else
+        uint32_t bits = 0;
+        for (size_t lane = 0; lane < LANE_WIDTH; ++lane) {
+            bits |= static_cast<uint32_t>(testSlot(box, layer, mask, first + lane)) << lane;
+        }
+        return bits;
+#endif
+    }
+
+    // 测试 box 与任意 count (<= 8) 个槽位（按索引收集）的重叠
+    // @return 位掩码，bit i 对应 indices[i]
+    uint32_t overlapMask8(const AABB& box, uint32_t layer, uint32_t mask,
+                          const uint32_t* indices, size_t indexCount) const {
+#if defined(__AVX2__)
+        if (indexCount == LANE_WIDTH) {
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+            __m256 overlap = overlapLanes(box,
+                _mm256_i32gather_ps(minX.data(), idx, 4), _mm256_i32gather_ps(minY.data(), idx, 4),
+                _mm256_i32gather_ps(minZ.data(), idx, 4), _mm256_i32gather_ps(maxX.data(), idx, 4),
+                _mm256_i32gather_ps(maxY.data(), idx, 4), _mm256_i32gather_ps(maxZ.data(), idx, 4));
+            __m256i layers = _mm256_i32gather_epi32(reinterpret_cast<const int*>(activeLayers.data()), idx, 4);
+            __m256i masks = _mm256_i32gather_epi32(reinterpret_cast<const int*>(collisionMasks.data()), idx, 4);
+            return combineFilter(overlap, layers, masks, layer, mask);
+        }
+#endif
+        uint32_t bits = 0;
+        for (size_t lane = 0; lane < indexCount; ++lane) {
+            bits |= static_cast<uint32_t>(testSlot(box, layer, mask, indices[lane])) << lane;
+        }
+        return bits;
+    }
+
+    // 线性扫描所有槽位，对每个与 box 重叠且通过层/掩码过滤的槽位调用 callback(index)
+    template<typename Callback>
+    void queryOverlaps(const AABB& box, uint32_t layer, uint32_t mask, Callback&& callback) const {
+        for (size_t first = 0; first < count; first += LANE_WIDTH) {
+            uint32_t bits = overlapMask8(box, layer, mask, first);
+            while (bits != 0) {
+                uint32_t lane = static_cast<uint32_t>(countTrailingZeros(bits));
+                bits &= bits - 1;
+                callback(static_cast<uint32_t>(first + lane));
+            }
+        }
+    }
+
+    // 对逐个产生的候选槽位（树叶子、网格桶）批量测试：凑满 8 个交给 overlapMask8，
+    // 紧包围盒重叠与层/掩码过滤一次完成，对每个命中的槽位调用 callback(index)
+    // generate(push) 负责产生候选，对每个候选调用 push(index)
+    template<typename Generate, typename Callback>
+    void batchOverlaps(const AABB& box, uint32_t layer, uint32_t mask,
+                       Generate&& generate, Callback&& callback) const {
+        uint32_t batch[LANE_WIDTH];
+        size_t batchCount = 0;
+        auto flush = [&]() {
+            uint32_t bits = overlapMask8(box, layer, mask, batch, batchCount);
+            while (bits != 0) {
+                uint32_t lane = static_cast<uint32_t>(countTrailingZeros(bits));
+                bits &= bits - 1;
+                callback(batch[lane]);
+            }
+            batchCount = 0;
+        };
+        generate([&](uint32_t index) {
+            batch[batchCount++] = index;
+            if (batchCount == LANE_WIDTH) flush();
+        });
+        if (batchCount > 0) flush();
+    }
+
+    // 位掩码遍历辅助
+    static int countTrailingZeros(uint32_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+    // === 脏列表（宽相增量更新） ===
+
+    // 标记槽位的包围盒/启用状态/层过滤已修改，每个槽位每帧只入列一次
+    void markDirty(size_t index) {
+        if (!dirtyFlags[index]) {
+            dirtyFlags[index] = true;
+            dirtyIndices.push_back(static_cast<uint32_t>(index));
+        }
+    }
+
+    // 获取自上次 clearDirty() 以来修改过的槽位
+    const std::vector<uint32_t>& getDirtyIndices() const { return dirtyIndices; }
+
+    // 宽相消费完脏列表后调用
+    void clearDirty() {
+        for (uint32_t index : dirtyIndices) {
+            dirtyFlags[index] = false;
+        }
+        dirtyIndices.clear();
     }
 
     // === 批量访问接口（用于高性能批处理） ===
 
-    // 获取所有包围盒最小点（直接访问 SOA 数组）
-    std::vector<glm::vec3>& getAllBoundingBoxMins() { return boundingBoxMins; }
-    const std::vector<glm::vec3>& getAllBoundingBoxMins() const { return boundingBoxMins; }
+    // 包围盒分量通道（长度为填充后的 8 的倍数）
+    const LaneVector<float>& getMinX() const { return minX; }
+    const LaneVector<float>& getMinY() const { return minY; }
+    const LaneVector<float>& getMinZ() const { return minZ; }
+    const LaneVector<float>& getMaxX() const { return maxX; }
+    const LaneVector<float>& getMaxY() const { return maxY; }
+    const LaneVector<float>& getMaxZ() const { return maxZ; }
+
+    // 局部包围盒与变换绑定（世界包围盒批处理阶段使用）
+    const std::vector<glm::vec3>& getAllLocalMins() const { return localMins; }
+    const std::vector<glm::vec3>& getAllLocalMaxs() const { return localMaxs; }
+    const std::vector<SoaHandle>& getAllTransformHandles() const { return transformHandles; }
+
+    // 上次计算世界包围盒时的世界矩阵版本（TransformDataStorage::getWorldVersion）
+    std::vector<uint32_t>& getAllSeenWorldVersions() { return seenWorldVersions; }
+
+    // 局部包围盒或绑定已修改，需要无条件重新计算（静态物体也包括在内）
+    std::vector<uint8_t>& getAllBoundsStale() { return boundsStale; }
+
+    // 自上次 clearStale() 以来变为 stale 的槽位（每个槽位只入列一次）
+    const std::vector<uint32_t>& getStaleIndices() const { return staleIndices; }
 
-    // 获取所有包围盒最大点
-    std::vector<glm::vec3>& getAllBoundingBoxMaxs() { return boundingBoxMaxs; }
-    const std::vector<glm::vec3>& getAllBoundingBoxMaxs() const { return boundingBoxMaxs; }
+    // 世界包围盒批处理阶段消费完 stale 列表后调用（标志由消费方清除）
+    void clearStale() { staleIndices.clear(); }
+
+    // 获取所有移动性标志（批处理阶段同步，调用方负责 markDirty）
+    std::vector<uint8_t>& getAllMobility() { return mobilityFlags; }
+    const std::vector<uint8_t>& getAllMobility() const { return mobilityFlags; }
+
+    // 获取所有窄相形状
+    const std::vector<CollisionShape>& getAllShapes() const { return shapes; }
+
+    // 休眠状态与静止时间（秒），由 CollisionSystem 每步更新
+    std::vector<uint8_t>& getAllSleepFlags() { return sleepFlags; }
+    const std::vector<uint8_t>& getAllSleepFlags() const { return sleepFlags; }
+    std::vector<float>& getAllSleepTimers() { return sleepTimers; }
+
+    // 获取所有连续碰撞检测标志
+    const std::vector<uint8_t>& getAllContinuousFlags() const { return continuousFlags; }
 
     // 获取所有碰撞层
     std::vector<uint32_t>& getAllCollisionLayers() { return collisionLayers; }
     const std::vector<uint32_t>& getAllCollisionLayers() const { return collisionLayers; }
 
-    // 获取所有碰撞掩码
-    std::vector<uint32_t>& getAllCollisionMasks() { return collisionMasks; }
-    const std::vector<uint32_t>& getAllCollisionMasks() const { return collisionMasks; }
+    // 获取所有碰撞掩码（长度为填充后的 8 的倍数）
+    const LaneVector<uint32_t>& getAllCollisionMasks() const { return collisionMasks; }
 
     // 获取所有启用标志
-    std::vector<bool>& getAllEnabledFlags() { return enabledFlags; }
     const std::vector<bool>& getAllEnabledFlags() const { return enabledFlags; }
 
     // 获取碰撞体数量
-    size_t getCount() const { return boundingBoxMins.size(); }
+    size_t getCount() const { return count; }
 
     // 清空所有数据
     void clear() {
-        boundingBoxMins.clear();
-        boundingBoxMaxs.clear();
+        minX.clear();
+        minY.clear();
+        minZ.clear();
+        maxX.clear();
+        maxY.clear();
+        maxZ.clear();
+        activeLayers.clear();
+        localMins.clear();
+        localMaxs.clear();
+        transformHandles.clear();
+        transformFirstSlots.clear();
+        nextSlotsOfTransform.clear();
+        owners.clear();
+        seenWorldVersions.clear();
+        boundsStale.clear();
+        staleIndices.clear();
+        mobilityFlags.clear();
+        shapes.clear();
+        sleepFlags.clear();
+        sleepTimers.clear();
+        continuousFlags.clear();
         collisionLayers.clear();
         collisionMasks.clear();
         enabledFlags.clear();
+        dirtyFlags.clear();
+        dirtyIndices.clear();
+        generations.clear();
+        removedSlots.clear();
+        freeSlots.clear();
+        count = 0;
     }
 
     // 获取内存占用（字节）
     size_t getMemoryUsage() const {
-        return boundingBoxMins.capacity() * sizeof(glm::vec3) +
-               boundingBoxMaxs.capacity() * sizeof(glm::vec3) +
+        return 6 * minX.capacity() * sizeof(float) +
+               activeLayers.capacity() * sizeof(uint32_t) +
+               (localMins.capacity() + localMaxs.capacity()) * sizeof(glm::vec3) +
+               transformHandles.capacity() * sizeof(SoaHandle) +
+               (transformFirstSlots.capacity() + nextSlotsOfTransform.capacity()) * sizeof(uint32_t) +
+               staleIndices.capacity() * sizeof(uint32_t) +
+               owners.capacity() * sizeof(std::weak_ptr<GameEntity>) +
+               seenWorldVersions.capacity() * sizeof(uint32_t) +
+               (boundsStale.capacity() + mobilityFlags.capacity()) * sizeof(uint8_t) +
+               shapes.capacity() * sizeof(CollisionShape) +
+               sleepFlags.capacity() * sizeof(uint8_t) +
+               sleepTimers.capacity() * sizeof(float) +
+               continuousFlags.capacity() * sizeof(uint8_t) +
                collisionLayers.capacity() * sizeof(uint32_t) +
                collisionMasks.capacity() * sizeof(uint32_t) +
-               enabledFlags.capacity() * sizeof(bool);
+               enabledFlags.capacity() / 8 +
+               dirtyFlags.capacity() / 8 +
+               dirtyIndices.capacity() * sizeof(uint32_t) +
+               (generations.capacity() + removedSlots.capacity() + freeSlots.capacity()) * sizeof(uint32_t);
     }
 
 private:
+    // 复用槽位：各列恢复 allocate() 的初始值（boundsStale 与 staleIndices 配对，保持不变）
+    void resetSlot(uint32_t index) {
+        setLaneBounds(index, glm::vec3(0.0f), glm::vec3(0.0f));
+        localMins[index] = glm::vec3(0.0f);
+        localMaxs[index] = glm::vec3(0.0f);
+        seenWorldVersions[index] = 0;
+        mobilityFlags[index] = 1;
+        shapes[index] = CollisionShape::Box;
+        sleepFlags[index] = 0;
+        sleepTimers[index] = 0.0f;
+        continuousFlags[index] = 0;
+        collisionLayers[index] = 1;
+        collisionMasks[index] = 0xFFFFFFFF;
+        activeLayers[index] = 1;
+        enabledFlags[index] = true;
+        markDirty(index);
+    }
+
+    // 局部包围盒/绑定变化后同步世界包围盒
+    void refreshBounds(size_t index) {
+        if (transformHandles[index] == NO_TRANSFORM) {
+            setLaneBounds(index, localMins[index], localMaxs[index]);
+            markDirty(index);
+        } else if (!boundsStale[index]) {
+            boundsStale[index] = 1;
+            staleIndices.push_back(static_cast<uint32_t>(index));
+        }
+    }
+
+    // 从旧变换的槽位链表中摘除（链表很短：通常一个变换只绑定一个碰撞体）
+    void unlinkTransformSlot(uint32_t index) {
+        SoaHandle old = transformHandles[index];
+        if (old == NO_TRANSFORM || old.index >= transformFirstSlots.size()) return;
+        uint32_t* link = &transformFirstSlots[old.index];
+        while (*link != NO_SLOT && *link != index) {
+            link = &nextSlotsOfTransform[*link];
+        }
+        if (*link == index) {
+            *link = nextSlotsOfTransform[index];
+        }
+        nextSlotsOfTransform[index] = NO_SLOT;
+    }
+
+    void setLaneBounds(size_t index, const glm::vec3& min, const glm::vec3& max) {
+        minX[index] = min.x;
+        minY[index] = min.y;
+        minZ[index] = min.z;
+        maxX[index] = max.x;
+        maxY[index] = max.y;
+        maxZ[index] = max.z;
+    }
+
+    // 单槽位标量测试（非 AVX2 路径与尾部）
+    bool testSlot(const AABB& box, uint32_t layer, uint32_t mask, size_t index) const {
+        return minX[index] <= box.max.x && maxX[index] >= box.min.x &&
+               minY[index] <= box.max.y && maxY[index] >= box.min.y &&
+               minZ[index] <= box.max.z && maxZ[index] >= box.min.z &&
+               (activeLayers[index] & mask) != 0 && (layer & collisionMasks[index]) != 0;
+    }
+
+#if defined(__AVX2__)
+    static __m256 overlapLanes(const AABB& box, __m256 bMinX, __m256 bMinY, __m256 bMinZ,
+                               __m256 bMaxX, __m256 bMaxY, __m256 bMaxZ) {
+        __m256 x = _mm256_and_ps(_mm256_cmp_ps(bMinX, _mm256_set1_ps(box.max.x), _CMP_LE_OQ),
+                                 _mm256_cmp_ps(bMaxX, _mm256_set1_ps(box.min.x), _CMP_GE_OQ));
+        __m256 y = _mm256_and_ps(_mm256_cmp_ps(bMinY, _mm256_set1_ps(box.max.y), _CMP_LE_OQ),
+                                 _mm256_cmp_ps(bMaxY, _mm256_set1_ps(box.min.y), _CMP_GE_OQ));
+        __m256 z = _mm256_and_ps(_mm256_cmp_ps(bMinZ, _mm256_set1_ps(box.max.z), _CMP_LE_OQ),
+                                 _mm256_cmp_ps(bMaxZ, _mm256_set1_ps(box.min.z), _CMP_GE_OQ));
+        return _mm256_and_ps(_mm256_and_ps(x, y), z);
+    }
+
+    // (layer_i & queryMask) != 0 && (queryLayer & mask_i) != 0，与重叠结果合并为位掩码
+    static uint32_t combineFilter(__m256 overlap, __m256i layers, __m256i masks, uint32_t layer, uint32_t mask) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i rejectLayer = _mm256_cmpeq_epi32(_mm256_and_si256(layers, _mm256_set1_epi32(static_cast<int>(mask))), zero);
+        __m256i rejectMask = _mm256_cmpeq_epi32(_mm256_and_si256(masks, _mm256_set1_epi32(static_cast<int>(layer))), zero);
+        __m256 reject = _mm256_castsi256_ps(_mm256_or_si256(rejectLayer, rejectMask));
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_andnot_ps(reject, overlap)));
+    }
+#endif
+
     // SOA 数据布局 - 每个属性单独存储在连续数组中
-    std::vector<glm::vec3> boundingBoxMins;   // 包围盒最小点
-    std::vector<glm::vec3> boundingBoxMaxs;   // 包围盒最大点
+    LaneVector<float> minX, minY, minZ;       // 世界包围盒最小点（分量通道）
+    LaneVector<float> maxX, maxY, maxZ;       // 世界包围盒最大点（分量通道）
+    std::vector<glm::vec3> localMins;         // 局部包围盒最小点
+    std::vector<glm::vec3> localMaxs;         // 局部包围盒最大点
+    std::vector<SoaHandle> transformHandles;  // 绑定的变换句柄
+    std::vector<uint32_t> transformFirstSlots;   // 按变换句柄索引，绑定槽位链表头（NO_SLOT 为空）
+    std::vector<uint32_t> nextSlotsOfTransform;  // 按槽位，同一变换的下一个槽位
+    std::vector<std::weak_ptr<GameEntity>> owners;  // 所属实体（拾取等查询把槽位映射回实体）
+    std::vector<uint32_t> seenWorldVersions;  // 上次使用的世界矩阵版本
+    std::vector<uint8_t> boundsStale;         // 需要重新计算世界包围盒
+    std::vector<uint32_t> staleIndices;       // boundsStale 被置位的槽位（供批处理阶段增量更新）
+    std::vector<uint8_t> mobilityFlags;       // 0 = Static, 1 = Movable
+    std::vector<CollisionShape> shapes;       // 窄相形状
+    std::vector<uint8_t> sleepFlags;          // 1 = 休眠
+    std::vector<float> sleepTimers;           // 连续静止时间（秒）
+    std::vector<uint8_t> continuousFlags;     // 1 = 连续碰撞检测
+    LaneVector<uint32_t> activeLayers;        // 有效碰撞层（禁用时为 0，供 SIMD 过滤）
+    LaneVector<uint32_t> collisionMasks;      // 碰撞掩码（用于过滤）
     std::vector<uint32_t> collisionLayers;    // 碰撞层（用于分组）
-    std::vector<uint32_t> collisionMasks;     // 碰撞掩码（用于过滤）
     std::vector<bool> enabledFlags;           // 启用标志
+    std::vector<bool> dirtyFlags;             // 是否已在脏列表中
+    std::vector<uint32_t> dirtyIndices;       // 本帧修改过的槽位（供宽相增量更新）
+    std::vector<uint32_t> generations;        // 槽位代数（移除时递增）
+    std::vector<uint32_t> removedSlots;       // 已移除、等待 CollisionSystem 清理的槽位
+    std::vector<uint32_t> freeSlots;          // 可复用的槽位
+    size_t count = 0;                         // 有效槽位数（通道长度按 8 填充）
 };
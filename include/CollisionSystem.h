@@ -0,0 +1,299 @@
+#pragma once
+
+#include "EntitySystem.h"
+#include "CollisionDataStorage.h"
+#include "DynamicAABBTree.h"
+#include "EventSystem.h"
+#include "Narrowphase.h"
+#include "PairCache.h"
+#include "UniformGridBroadphase.h"
+#include "ThreadPool.h"
+#include "TransformDataStorage.h"
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstdint>
+
+/// Broadphase algorithm used for overlap pair generation
+enum class BroadphaseType {
+    DynamicTree,    // Dynamic AABB tree - logarithmic queries, robust on clustered data
+    UniformGrid,    // Flat 2D spatial hash - best for many similarly sized objects
+    SweepAndPrune   // Sort-and-sweep on X - baseline for comparison
+};
+
+/// Result selection for spatial queries
+enum class QueryMode {
+    Closest,    // Only the nearest hit (ray: smallest distance, point: nearest box center)
+    All         // Every hit, sorted by distance (ray) or slot index (point/box)
+};
+
+/// Ray cast hit against a collider's world AABB
+struct RaycastHit {
+    uint32_t index = 0;             // CollisionDataStorage slot
+    float distance = 0.0f;          // Distance along the normalized ray direction
+    glm::vec3 point = glm::vec3(0.0f);
+};
+
+/// Continuous collision hit: first contact of a flagged fast body's swept AABB
+struct ContinuousHit {
+    uint32_t index = 0;             // Moving (continuous) slot
+    uint32_t other = 0;             // Slot hit during the sweep
+    float toi = 0.0f;               // Time of impact as a fraction of this step's motion, in (0, 1]
+    glm::vec3 normal = glm::vec3(0.0f);     // Face normal of other at the contact (towards index)
+    glm::vec3 position = glm::vec3(0.0f);   // World AABB center of index at the time of impact
+};
+
+/// Batches of overlap transitions for one frame, dispatched through EventSystem::dispatch<E>
+/// One event per type per frame carries every pair (slot indices, a < b, sorted);
+/// the span is only valid for the duration of the dispatch
+struct CollisionBeginEvent {
+    std::span<const CollisionPair> pairs;   // Pairs that started overlapping
+};
+
+struct CollisionEndEvent {
+    std::span<const CollisionPair> pairs;   // Pairs that stopped overlapping
+};
+
+/// Collision broadphase system fed from the shared CollisionDataStorage
+/// Each step first refreshes world AABBs of slots bound to a transform whose
+/// world matrix changed (local AABB -> world AABB, abs-matrix extents), then keeps two
+/// DynamicAABBTrees in sync with the SOA bounds (only dirty slots are touched each frame):
+/// - Static colliders live in a tight (zero margin) tree bulk-built with SAH, never refit
+/// - Movable colliders live in a fattened dynamic tree
+/// Slots migrate between the trees when their transform's mobility changes. Pairs are
+/// layer/mask filtered and only dynamic-vs-dynamic and dynamic-vs-static are generated.
+/// With the tree broadphase the persistent pair set is maintained incrementally: proxies
+/// touched by the sync go into a move buffer, only those are queried against the trees and
+/// only the cached pairs touching them are re-tested; the grid and sweep-and-prune
+/// broadphases regenerate the full list and diff it (comparison baselines)
+/// Movable bodies at rest sleep by island (union-find over contacts): sleeping bodies are
+/// parked in the static tree, so they are neither refit nor paired with each other; their
+/// cached pairs stay frozen and the island is stored, so waking any member wakes all of it
+/// Bodies flagged continuous additionally sweep their AABB from the previous to the current
+/// bounds through both trees and report a time of impact, so fast movers cannot tunnel
+/// through thin geometry between steps
+class CollisionSystem : public EntitySystem {
+public:
+    CollisionSystem(const std::string& name = "CollisionSystem");
+    ~CollisionSystem() override;
+
+    void initialize() override;
+    void update(float deltaTime) override;
+    void shutdown() override;
+
+    /// Set the storage to read bounds from (defaults to CollisionComponent's shared storage)
+    void setStorage(std::shared_ptr<CollisionDataStorage> storage) { this->storage = storage; }
+    std::shared_ptr<CollisionDataStorage> getStorage() const { return storage; }
+
+    /// Set the transform storage world matrices are read from (defaults to TransformComponent's shared storage)
+    void setTransformStorage(std::shared_ptr<TransformDataStorage> storage) { transformStorage = storage; }
+
+    /// Run the broadphase for this frame
+    /// Call after transforms have been updated
+    void step(float deltaTime);
+
+    /// Recompute world AABBs of slots bound to a transform
+    /// Only slots bound to transforms in TransformDataStorage's world change list (and stale
+    /// slots) are visited; drains both lists
+    void updateWorldBounds();
+
+    /// Number of world AABBs recomputed by the last updateWorldBounds()
+    size_t getLastWorldBoundsUpdateCount() const { return lastWorldBoundsUpdateCount; }
+
+    // === Spatial queries (world AABBs as of the last step(), backed by the tree) ===
+    // layerMask selects colliders whose layer shares a bit with it; disabled colliders are never reported
+
+    /// Cast a ray segment origin + t * direction, t in [0, maxDistance]
+    /// @return Number of hits appended to outHits (cleared first)
+    size_t raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                   uint32_t layerMask, QueryMode mode, std::vector<RaycastHit>& outHits) const;
+
+    /// Colliders whose world AABB contains the point
+    /// @return Number of slots appended to outIndices (cleared first)
+    size_t pointQuery(const glm::vec3& point, uint32_t layerMask, QueryMode mode,
+                      std::vector<uint32_t>& outIndices) const;
+
+    /// Colliders whose world AABB overlaps the box, sorted by slot index
+    /// @return Number of slots appended to outIndices (cleared first)
+    size_t queryAABB(const AABB& box, uint32_t layerMask, std::vector<uint32_t>& outIndices) const;
+
+    /// Rebuild both trees with binned SAH (e.g. after level load)
+    void rebuildTree();
+
+    /// Overlap pairs as of the last step() (the persistent pair set, unordered)
+    const std::vector<CollisionPair>& getOverlapPairs() const { return pairCache.getPairs(); }
+
+    /// Contacts from the narrowphase of the last step() (empty when disabled)
+    const std::vector<Contact>& getContacts() const { return contacts; }
+
+    /// Run exact shape tests on the overlap pairs each step (default on)
+    void setNarrowphaseEnabled(bool enabled) { narrowphaseEnabled = enabled; }
+    bool isNarrowphaseEnabled() const { return narrowphaseEnabled; }
+
+    /// Enable island sleeping (default on); disabling wakes every body
+    void setSleepingEnabled(bool enabled);
+    bool isSleepingEnabled() const { return sleepingEnabled; }
+
+    /// Bodies whose bounds move less than linearThreshold (units/second) for
+    /// timeToSleep seconds, together with their whole island, go to sleep
+    void setSleepThresholds(float linearThreshold, float timeToSleep) {
+        sleepLinearThreshold = linearThreshold;
+        this->timeToSleep = timeToSleep;
+    }
+
+    /// Movable bodies currently awake (leaves of the dynamic tree)
+    size_t getAwakeBodyCount() const { return awakeBodies.size(); }
+
+    /// Islands (awake bodies and the sleeping bodies they touch) found by the last step()
+    size_t getLastIslandCount() const { return lastIslandCount; }
+
+    /// Swept-AABB hits of continuous bodies found by the last step(), sorted by (index, toi)
+    /// Other bodies are taken at their end-of-step bounds; hits already overlapping at the
+    /// start of the step are left to the discrete pairs
+    const std::vector<ContinuousHit>& getContinuousHits() const { return continuousHits; }
+
+    /// Persistent overlap set - "stay" state is a lookup, only transitions generate events
+    const PairCache& getPairCache() const { return pairCache; }
+
+    /// Pairs that started / stopped overlapping in the last step()
+    const std::vector<CollisionPair>& getBeginPairs() const { return beginPairs; }
+    const std::vector<CollisionPair>& getEndPairs() const { return endPairs; }
+
+    /// Event system receiving CollisionBeginEvent / CollisionEndEvent batches after each step()
+    void setEventSystem(std::shared_ptr<EventSystem> system) { eventSystem = system; }
+
+    /// Access the spatial indices (Movable / Static colliders)
+    const DynamicAABBTree& getTree() const { return tree; }
+    const DynamicAABBTree& getStaticTree() const { return staticTree; }
+
+    /// Fat margin for dynamic leaves (world units)
+    void setFatMargin(float margin) { tree.setFatMargin(margin); }
+
+    /// Select the dynamic-vs-dynamic pair algorithm (the trees are always kept for queries)
+    void setBroadphaseType(BroadphaseType type) { broadphaseType = type; }
+    BroadphaseType getBroadphaseType() const { return broadphaseType; }
+
+    /// Access the grid broadphase (cell size configuration)
+    UniformGridBroadphase& getGrid() { return grid; }
+
+    /// Share a worker pool (created on initialize() if not set)
+    void setThreadPool(std::shared_ptr<ThreadPool> pool) { threadPool = pool; }
+    std::shared_ptr<ThreadPool> getThreadPool() const { return threadPool; }
+
+    /// Time every broadphase on the current storage contents and print the results
+    /// @param iterations - Pair generation passes per broadphase
+    void benchmarkBroadphases(int iterations = 20);
+
+    /// Duration of the last step() in milliseconds
+    double getLastStepTimeMs() const { return lastStepTimeMs; }
+
+private:
+    /// Apply the storage dirty list to the tree (insert/move/remove leaves)
+    /// Every touched slot is appended to the move buffer
+    void syncProxies();
+    void bufferMove(uint32_t index);
+
+    /// Hand slots removed from the storage back for reuse (their proxy and pairs are gone)
+    void releaseRetiredSlots();
+
+    /// Incremental pair update from the move buffer (tree broadphase)
+    void updateMovedPairs();
+
+    /// Whether a pair belongs in the overlap set: both in a tree, layer/mask compatible and
+    /// tight bounds overlapping - or, with neither side awake, frozen while one of them sleeps
+    bool isPairActive(uint32_t a, uint32_t b) const;
+
+    /// Regenerate the full overlap pair list with the given broadphase
+    void findOverlapPairs(BroadphaseType type);
+    void findPairsTree();
+    void findPairsGrid();
+    void findPairsSweepAndPrune();
+    void findDynamicStaticPairs();
+
+    /// Sweep continuous bodies that moved this step against both trees
+    void findContinuousHits();
+
+    /// Update the pair cache (incrementally, or by diffing a regenerated list) and
+    /// dispatch the transition batches
+    void updatePairCache();
+
+    /// Accumulate rest time, build contact islands and put islands to sleep / wake them
+    void updateSleep(float deltaTime);
+    uint32_t findIsland(uint32_t index);
+
+    /// Wake a sleeping body and every member of its stored island (they migrate on the next sync)
+    void wakeIsland(uint32_t index);
+
+    void addAwakeBody(uint32_t index);
+    void removeAwakeBody(uint32_t index);
+
+    static constexpr uint32_t NOT_AWAKE = UINT32_MAX;
+    static constexpr uint32_t NO_ISLAND = UINT32_MAX;
+
+    std::shared_ptr<CollisionDataStorage> storage;
+    std::shared_ptr<TransformDataStorage> transformStorage;
+    std::shared_ptr<ThreadPool> threadPool;
+    std::weak_ptr<EventSystem> eventSystem;
+    BroadphaseType broadphaseType = BroadphaseType::DynamicTree;
+
+    DynamicAABBTree tree;                   // Movable colliders (fat leaves)
+    DynamicAABBTree staticTree;             // Static colliders (tight leaves, SAH-built)
+    std::vector<int32_t> proxyIds;          // Per storage slot, NULL_NODE when not in a tree
+    std::vector<uint8_t> proxyInStaticTree; // Per storage slot, which tree proxyIds refers to
+    size_t staticChangesSinceBuild = 0;     // Incremental static inserts/removals since the last SAH build
+    std::vector<std::vector<CollisionPair>> chunkPairs;  // Per-chunk pair query output
+    std::vector<uint32_t> moveBuffer;       // Slots touched since the pair cache last consumed them
+    std::vector<uint8_t> moveFlags;         // Per slot, already in the move buffer
+    std::vector<uint32_t> retiredSlots;     // Removed slots whose proxy is gone, released after the pair update
+
+    // Sleeping
+    bool sleepingEnabled = true;
+    float sleepLinearThreshold = 0.005f;    // Units per second
+    float timeToSleep = 0.5f;               // Seconds at rest before an island sleeps
+    float stepDeltaTime = 0.0f;
+    std::vector<AABB> lastBounds;           // Per slot, bounds at the last sync (motion measure)
+    std::vector<uint8_t> movedThisStep;     // Per slot, moved faster than the threshold this step
+    std::vector<uint32_t> awakeBodies;      // Slots in the dynamic tree
+    std::vector<uint32_t> awakePositions;   // Per slot, index into awakeBodies or NOT_AWAKE
+    std::vector<uint32_t> sleepIslandIds;   // Per slot, island it sleeps in (root slot at sleep time) or NO_ISLAND
+    std::vector<std::vector<uint32_t>> sleepingIslands;  // Per island id, its sleeping members
+
+    // Continuous collision
+    struct SweptBody {
+        uint32_t index;
+        AABB start;                         // Bounds at the previous sync
+    };
+    std::vector<SweptBody> sweptBodies;     // Continuous bodies that moved this step
+    std::vector<ContinuousHit> continuousHits;
+
+    // Union-find scratch, reset lazily by islandFrame stamp
+    std::vector<uint32_t> islandParents;
+    std::vector<uint32_t> islandStamps;
+    std::vector<float> islandMinTimers;
+    std::vector<uint8_t> islandMoved;
+    std::vector<uint32_t> islandMembers;
+    uint32_t islandFrame = 0;
+    size_t lastIslandCount = 0;
+    std::vector<CollisionPair> overlapPairs;  // Full regeneration output (grid/SAP, benchmark)
+
+    UniformGridBroadphase grid;
+
+    Narrowphase narrowphase;
+    std::vector<Contact> contacts;
+    bool narrowphaseEnabled = true;
+
+    PairCache pairCache;
+    std::vector<CollisionPair> beginPairs;
+    std::vector<CollisionPair> endPairs;
+
+    // Sweep-and-prune: enabled slots kept sorted by min.x across frames
+    std::vector<uint32_t> sweepOrder;
+    bool sweepOrderDirty = true;
+
+    std::vector<uint32_t> boundsWork;       // Slots to refresh this step (changed transforms + stale)
+    std::vector<uint8_t> boundsQueued;      // Per slot, already in boundsWork
+    std::vector<std::vector<uint32_t>> chunkUpdatedSlots;  // Per-chunk world AABB updates
+    size_t lastWorldBoundsUpdateCount = 0;
+
+    double lastStepTimeMs = 0.0;
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "AABB.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+/// Dynamic bounding volume hierarchy for collision and spatial queries
+/// - Leaves store fattened AABBs so small movements don't touch the tree
+/// - Incremental insert picks the cheapest sibling by surface area, then
+///   rotates nodes on the way up to keep the tree height-balanced
+/// - All nodes live in one contiguous pool (std::vector) linked by index,
+///   freed nodes are recycled through a free list
+/// - rebuildSAH() rebuilds the whole tree top-down with binned SAH,
+///   intended for the static set after level load
+class DynamicAABBTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    /// @param fatMargin - Margin added on every side of leaf boxes (0 = tight, for static sets)
+    explicit DynamicAABBTree(float fatMargin = 0.01f);
+
+    /// Create a leaf proxy for a tight AABB, returns the proxy ID
+    /// @param userData - Caller payload (e.g. CollisionDataStorage index)
+    int32_t createProxy(const AABB& aabb, uint32_t userData);
+
+    /// Remove a leaf proxy from the tree
+    void destroyProxy(int32_t proxyId);
+
+    /// Update a proxy with its new tight AABB
+    /// Only reinserts the leaf when the box escapes its fat AABB
+    /// @return true if the leaf was reinserted
+    bool moveProxy(int32_t proxyId, const AABB& aabb);
+
+    /// Get proxy payload
+    uint32_t getUserData(int32_t proxyId) const { return nodes[proxyId].userData; }
+
+    /// Get the fattened AABB stored in the leaf
+    const AABB& getFatAABB(int32_t proxyId) const { return nodes[proxyId].aabb; }
+
+    /// Query all proxies whose fat AABB overlaps the box
+    /// @param callback - bool(int32_t proxyId), return false to stop the query
+    template<typename Callback>
+    void queryAABB(const AABB& aabb, Callback&& callback) const;
+
+    /// Query all proxies whose fat AABB contains the point
+    /// @param callback - bool(int32_t proxyId), return false to stop the query
+    template<typename Callback>
+    void queryPoint(const glm::vec3& point, Callback&& callback) const;
+
+    /// Cast a ray segment origin + t * dir, t in [0, maxT], against the fat AABBs
+    /// @param callback - float(int32_t proxyId, float maxT) called for every candidate leaf:
+    ///                   return 0 to terminate, a value < 0 to ignore the proxy,
+    ///                   or a new (smaller) maxT to clip the ray
+    template<typename Callback>
+    void raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT, Callback&& callback) const;
+
+    /// Report every pair of leaves whose fat AABBs overlap, each pair once
+    /// Visits every leaf - full regeneration only; per-frame pairs come from querying
+    /// the proxies in CollisionSystem's move buffer
+    /// @param callback - void(int32_t proxyA, int32_t proxyB)
+    template<typename Callback>
+    void queryAllPairs(Callback&& callback) const;
+
+    /// Rebuild the whole tree top-down with binned SAH from the current leaves
+    /// Produces a tighter tree than incremental insertion; O(n log n)
+    void rebuildSAH();
+
+    /// Remove every proxy (keeps the node pool allocation)
+    void clear();
+
+    /// Fat margin used for new and reinserted leaves
+    void setFatMargin(float margin) { fatMargin = margin; }
+    float getFatMargin() const { return fatMargin; }
+
+    /// Tree statistics
+    int32_t getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+    int32_t getProxyCount() const { return proxyCount; }
+    size_t getNodeCapacity() const { return nodes.size(); }
+
+    /// Sum of internal node areas divided by root area (lower is better)
+    float getAreaRatio() const;
+
+    /// Get memory usage (bytes)
+    size_t getMemoryUsage() const { return nodes.capacity() * sizeof(TreeNode); }
+
+private:
+    struct TreeNode {
+        AABB aabb;
+        int32_t parent = NULL_NODE;   // Reused as "next" while on the free list
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = -1;          // Leaf = 0, free node = -1
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    /// Small fixed-capacity stack for traversal, spills to the heap for very deep trees
+    /// Local to each query so concurrent queries on a const tree are safe
+    class TraversalStack {
+    public:
+        void push(int32_t value) {
+            if (count < INLINE_CAPACITY) {
+                inlineData[count++] = value;
+            } else {
+                overflow.push_back(value);
+                ++count;
+            }
+        }
+        int32_t pop() {
+            --count;
+            if (count >= INLINE_CAPACITY) {
+                int32_t value = overflow.back();
+                overflow.pop_back();
+                return value;
+            }
+            return inlineData[count];
+        }
+        bool empty() const { return count == 0; }
+
+    private:
+        static constexpr int32_t INLINE_CAPACITY = 128;
+        int32_t inlineData[INLINE_CAPACITY];
+        std::vector<int32_t> overflow;
+        int32_t count = 0;
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t nodeId);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t balance(int32_t nodeId);
+    void refitAncestors(int32_t nodeId);
+    int32_t buildSAHRange(int32_t* leaves, int32_t count);
+
+    std::vector<TreeNode> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    int32_t proxyCount = 0;
+    float fatMargin = 0.01f;
+};
+
+// === Template query implementations (inlined into callers' hot loops) ===
+
+template<typename Callback>
+void DynamicAABBTree::queryAABB(const AABB& aabb, Callback&& callback) const {
+    if (root == NULL_NODE) return;
+
+    TraversalStack stack;
+    stack.push(root);
+    while (!stack.empty()) {
+        int32_t nodeId = stack.pop();
+        const TreeNode& node = nodes[nodeId];
+        if (!node.aabb.overlaps(aabb)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(nodeId)) return;
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::queryPoint(const glm::vec3& point, Callback&& callback) const {
+    if (root == NULL_NODE) return;
+
+    TraversalStack stack;
+    stack.push(root);
+    while (!stack.empty()) {
+        int32_t nodeId = stack.pop();
+        const TreeNode& node = nodes[nodeId];
+        if (!node.aabb.contains(point)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(nodeId)) return;
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT, Callback&& callback) const {
+    if (root == NULL_NODE) return;
+
+    TraversalStack stack;
+    stack.push(root);
+    while (!stack.empty()) {
+        int32_t nodeId = stack.pop();
+        const TreeNode& node = nodes[nodeId];
+
+        float tEnter = 0.0f;
+        if (!node.aabb.intersectRay(origin, dir, maxT, tEnter)) continue;
+
+        if (node.isLeaf()) {
+            float value = callback(nodeId, maxT);
+            if (value == 0.0f) return;      // Terminated by caller
+            if (value > 0.0f) maxT = value; // Clip the ray
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::queryAllPairs(Callback&& callback) const {
+    // Each leaf queries the tree with its own fat box; only pairs with
+    // otherId > leafId are reported so every pair appears exactly once
+    for (int32_t leafId = 0; leafId < static_cast<int32_t>(nodes.size()); ++leafId) {
+        const TreeNode& leaf = nodes[leafId];
+        if (leaf.height != 0) continue;
+
+        queryAABB(leaf.aabb, [&](int32_t otherId) {
+            if (otherId > leafId) {
+                callback(leafId, otherId);
+            }
+            return true;
+        });
+    }
+}
@@ -23,8 +23,8 @@ public:
 
     const std::string& getName() const { return componentName; }
 
-    /// Set the owner entity
-    void setOwner(std::shared_ptr<GameEntity> entity) { owner = entity; }
+    /// Set the owner entity (components mirroring it into SOA storage override this)
+    virtual void setOwner(std::shared_ptr<GameEntity> entity) { owner = entity; }
 
     /// Get the owner entity
     std::shared_ptr<GameEntity> getOwner() const { return owner.lock(); }
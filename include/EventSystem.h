@@ -1,12 +1,23 @@
 #pragma once
 
 #include "EntitySystem.h"
+#include "FrameArena.h"
+#include "MpscQueue.h"
 #include <functional>
 #include <map>
 #include <vector>
 #include <string>
 #include <memory>
+#include <span>
 #include <any>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cassert>
+#include <type_traits>
+#include <cstring>
+#include <new>
+#include <cstdint>
 
 /// Event data base class
 class EventData {
@@ -24,17 +35,477 @@ private:
 /// Event callback type
 using EventCallback = std::function<void(const std::shared_ptr<EventData>&)>;
 
+// === Typed events ===
+// Any class type can be an event: dispatch<E>() passes it by reference to the handlers
+// registered for exactly that type. No strings, no heap allocation per event.
+
+/// Dense per-type index into EventSystem's channel table
+using EventTypeId = uint32_t;
+
+namespace EventTypes {
+    /// Size of EventSystem's channel table - every event type id is below this
+    constexpr size_t MAX_TYPES = 256;
+
+    /// Hand out the next id (called once per event type during static initialization)
+    /// Terminates with an error once MAX_TYPES ids have been handed out, in every build
+    EventTypeId allocateId();
+
+    /// Id of event type E - a constant after static initialization, read without a lookup
+    template<typename E>
+    inline const EventTypeId id = allocateId();
+}
+
+/// Typed events are plain class types (not the legacy shared_ptr<EventData> path)
+template<typename E>
+concept TypedEvent = std::is_class_v<E> && !std::is_convertible_v<const E&, std::shared_ptr<EventData>>;
+
+/// Type-erased handler: one indirect call through a plain function pointer
+/// The callable is allocated once at subscribe time, never on dispatch
+template<typename E>
+class EventHandler {
+public:
+    template<typename Fn>
+    explicit EventHandler(Fn&& fn)
+        : invoke([](void* target, const E& event) { (*static_cast<std::decay_t<Fn>*>(target))(event); })
+        , target(std::make_shared<std::decay_t<Fn>>(std::forward<Fn>(fn))) {}
+
+    void operator()(const E& event) const { invoke(target.get(), event); }
+
+private:
+    void (*invoke)(void* target, const E& event);
+    std::shared_ptr<void> target;
+};
+
+/// Handle returned by subscribe(), passed to unsubscribe()
+/// Slot plus generation: unsubscribing twice, or with a handle whose slot was reused, is a no-op
+struct EventSubscription {
+    EventTypeId type = UINT32_MAX;
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return slot != UINT32_MAX; }
+};
+
+/// Handlers in subscription order behind stable slot handles
+/// remove() only tombstones the entry (O(1), safe while the list is being walked);
+/// tombstones are compacted when the outermost forEach() finishes, or outside a walk once
+/// they make up more than half of the list (each compaction then reclaims at least as many
+/// entries as it moves, so removal stays amortized O(1))
+/// Handler must survive being moved while it runs (a handler may subscribe and grow the
+/// list) - EventHandler qualifies, its callable lives on the heap
+template<typename Handler>
+class SubscriberList {
+public:
+    /// @return slot, generation written to outGeneration
+    uint32_t add(Handler handler, uint32_t& outGeneration) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slotToEntry.size());
+            slotToEntry.push_back(0);
+            generations.push_back(0);
+        }
+        slotToEntry[slot] = static_cast<uint32_t>(entries.size());
+        entries.push_back({std::move(handler), slot, true});
+        outGeneration = generations[slot];
+        return slot;
+    }
+
+    bool remove(uint32_t slot, uint32_t generation) {
+        if (slot >= generations.size() || generations[slot] != generation) return false;
+        entries[slotToEntry[slot]].alive = false;
+        ++generations[slot];
+        freeSlots.push_back(slot);
+        ++tombstones;
+        if (depth == 0 && tombstones * 2 > entries.size()) compact();
+        return true;
+    }
+
+    /// Call fn(handler) for every live handler
+    /// Handlers added during the walk are not visited; removed ones are skipped
+    template<typename Fn>
+    void forEach(Fn&& fn) {
+        ++depth;
+        const size_t count = entries.size();
+        for (size_t i = 0; i < count; ++i) {
+            // Indexed - a handler may add entries (and grow the vector) while we walk
+            if (entries[i].alive) fn(entries[i].handler);
+        }
+        if (--depth == 0 && tombstones > 0) compact();
+    }
+
+    size_t size() const { return entries.size() - tombstones; }
+    bool empty() const { return size() == 0; }
+
+private:
+    struct Entry {
+        Handler handler;
+        uint32_t slot;
+        bool alive;
+    };
+
+    /// Stable removal of tombstones, repointing the slots of moved entries
+    void compact() {
+        size_t write = 0;
+        for (size_t read = 0; read < entries.size(); ++read) {
+            if (!entries[read].alive) continue;
+            if (write != read) {
+                entries[write] = std::move(entries[read]);
+                slotToEntry[entries[write].slot] = static_cast<uint32_t>(write);
+            }
+            ++write;
+        }
+        entries.erase(entries.begin() + write, entries.end());
+        tombstones = 0;
+    }
+
+    std::vector<Entry> entries;         // Subscription order, may contain tombstones
+    std::vector<uint32_t> slotToEntry;  // Slot -> index into entries
+    std::vector<uint32_t> generations;  // Per slot, bumped on removal
+    std::vector<uint32_t> freeSlots;
+    size_t tombstones = 0;
+    uint32_t depth = 0;                 // Nested forEach() calls in progress
+};
+
+/// How queue() folds events of one type that share a key within a frame
+enum class CoalescePolicy {
+    None,           // Every event is delivered
+    KeepLast,       // Later event replaces the queued one (keeps the first one's position)
+    Accumulate,     // Later event is merged into the queued one
+    DropDuplicates  // Later event is dropped
+};
+
+/// Per-frame key -> queued event index (open addressing, cleared lazily by stamp)
+class CoalesceTable {
+public:
+    /// Index already stored for key, or store index and return it
+    uint32_t findOrInsert(uint64_t key, uint32_t index);
+
+    /// Forget every key (O(1))
+    void reset();
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t index;
+        uint32_t stamp;     // Entry is live when stamp matches the table's
+    };
+
+    void grow();
+
+    std::vector<Entry> entries;
+    uint32_t stamp = 1;
+    uint32_t count = 0;
+    uint32_t bits = 0;
+};
+
+/// Backpressure counters of a postable event type
+struct EventPostStats {
+    uint64_t posted = 0;        // Accepted by post()
+    uint64_t dropped = 0;       // Rejected because the ring was full
+    size_t capacity = 0;        // Ring size (events)
+    size_t highWater = 0;       // Most events drained by one processQueue()
+};
+
+/// Delivery class of a queued event type
+/// processQueue() delivers High types first, then Normal, then Low. Only Low events are
+/// subject to the frame budget - whatever does not fit carries over to the next frame.
+enum class EventPriority : uint8_t {
+    High,       // Gameplay-critical, delivered first
+    Normal,     // Always delivered in the frame it was queued
+    Low         // Cosmetic, may be deferred when the frame budget runs out
+};
+
+/// Point in time after which Low priority delivery stops for the frame
+struct EventDeadline {
+    std::chrono::steady_clock::time_point time;
+
+    bool expired() const { return std::chrono::steady_clock::now() >= time; }
+};
+
+/// Carry-over state of the Low priority queue after the last processQueue()
+struct EventBacklogStats {
+    size_t backlog = 0;             // Events carried over to the next frame
+    size_t backlogTypes = 0;        // Event types with a backlog
+    size_t peakBacklog = 0;         // Largest backlog seen so far
+    uint32_t framesWithBacklog = 0; // Consecutive processQueue() calls that left a backlog
+    uint64_t framesOverBudget = 0;  // processQueue() calls that took longer than the budget
+    float lastProcessMs = 0.0f;     // Wall time of the last processQueue()
+};
+
+/// Per-type handler list plus the events queued for it
+/// Queued events live by value in one contiguous buffer per type and queue buffer,
+/// carved out of that buffer's FrameArena (grown by doubling, old storage is simply
+/// abandoned until the arena resets)
+class EventChannelBase {
+public:
+    virtual ~EventChannelBase() = default;
+
+    /// Dispatch and drop the events queued in one buffer, after any backlog from earlier frames
+    /// @param deadline - Stop once it expires and keep the rest as backlog (nullptr: deliver all)
+    /// @return Events left in the backlog
+    virtual size_t processQueued(uint32_t buffer, const EventDeadline* deadline) = 0;
+
+    /// Events deferred by an expired deadline, delivered by the next processQueued()
+    virtual size_t getBacklogCount() const = 0;
+
+    /// Move events posted from other threads into a queue buffer
+    /// @return true if the type had no events in the buffer before
+    virtual bool drainPosted(FrameArena& arena, uint32_t buffer) = 0;
+
+    virtual bool unsubscribe(uint32_t slot, uint32_t generation) = 0;
+
+    EventPriority priority = EventPriority::Normal;
+};
+
+template<typename E>
+class EventChannel : public EventChannelBase {
+public:
+    /// Slots of batch subscriptions are tagged so unsubscribe() knows which list to use
+    static constexpr uint32_t BATCH_SLOT = 1u << 31;
+
+    void dispatch(const E& event) {
+        handlers.forEach([&](const EventHandler<E>& handler) { handler(event); });
+        if (!batchHandlers.empty()) {
+            deliverBatch(std::span<const E>(&event, 1));
+        }
+    }
+
+    void deliverBatch(std::span<const E> events) {
+        batchHandlers.forEach([&](const EventHandler<std::span<const E>>& handler) { handler(events); });
+    }
+
+    bool unsubscribe(uint32_t slot, uint32_t generation) override {
+        if (slot & BATCH_SLOT) {
+            return batchHandlers.remove(slot & ~BATCH_SLOT, generation);
+        }
+        return handlers.remove(slot, generation);
+    }
+
+    bool hasSubscribers() const { return !handlers.empty() || !batchHandlers.empty(); }
+
+    void setCoalescing(CoalescePolicy policy, uint64_t (*key)(const E&), void (*merge)(E&, const E&)) {
+        coalescePolicy = key ? policy : CoalescePolicy::None;
+        coalesceKey = key;
+        coalesceMerge = merge;
+    }
+
+    /// Append to a queue buffer, or fold into a queued event with the same key
+    /// @return true if this is the first event of the type in the buffer
+    bool push(FrameArena& arena, uint32_t buffer, const E& event) {
+        QueueBuffer& queue = queued[buffer];
+        if (coalescePolicy != CoalescePolicy::None) {
+            uint32_t index = coalesceTables[buffer].findOrInsert(coalesceKey(event), queue.count);
+            if (index != queue.count) {
+                if (coalescePolicy == CoalescePolicy::KeepLast) {
+                    queue.events[index] = event;
+                } else if (coalescePolicy == CoalescePolicy::Accumulate) {
+                    coalesceMerge(queue.events[index], event);
+                }
+                ++coalescedCount;
+                return false;
+            }
+        }
+        if (queue.count == queue.capacity) {
+            uint32_t capacity = queue.capacity == 0 ? 64 : queue.capacity * 2;
+            E* events = arena.allocateArray<E>(capacity);
+            if (queue.count > 0) {
+                std::memcpy(static_cast<void*>(events), queue.events, queue.count * sizeof(E));
+            }
+            queue.events = events;
+            queue.capacity = capacity;
+        }
+        new (&queue.events[queue.count++]) E(event);
+        return queue.count == 1;
+    }
+
+    size_t processQueued(uint32_t buffer, const EventDeadline* deadline) override {
+        QueueBuffer& queue = queued[buffer];
+        // Oldest first: this buffer only starts once the backlog is gone
+        size_t done = deliver(backlog.data(), backlog.size(), deadline);
+        backlog.erase(backlog.begin(), backlog.begin() + done);
+        done = backlog.empty() ? deliver(queue.events, queue.count, deadline) : 0;
+        // The rest outlives the arena - copy it out (no coalescing against later frames)
+        backlog.insert(backlog.end(), queue.events + done, queue.events + queue.count);
+
+        queue = QueueBuffer{};  // Storage belongs to the arena
+        coalesceTables[buffer].reset();
+        return backlog.size();
+    }
+
+    size_t getBacklogCount() const override { return backlog.size(); }
+
+    size_t getQueuedCount(uint32_t buffer) const { return queued[buffer].count; }
+
+    /// Thread-safe: lock-free push into the bounded ring
+    bool post(const E& event) {
+        if (postQueue->tryPush(event)) {
+            posted.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool drainPosted(FrameArena& arena, uint32_t buffer) override {
+        bool first = false;
+        size_t drained = 0;
+        E event;
+        while (postQueue->tryPop(event)) {
+            first |= push(arena, buffer, event);
+            ++drained;
+        }
+        highWater = std::max(highWater, drained);
+        return first;
+    }
+
+    EventPostStats getPostStats() const {
+        EventPostStats stats;
+        stats.posted = posted.load(std::memory_order_relaxed);
+        stats.dropped = dropped.load(std::memory_order_relaxed);
+        stats.capacity = postQueue ? postQueue->capacity() : 0;
+        stats.highWater = highWater;
+        return stats;
+    }
+
+    /// Events folded into an earlier one by the coalescing policy
+    uint64_t getCoalescedCount() const { return coalescedCount; }
+
+    /// Events delivered between two deadline checks - also the least delivered per call,
+    /// so a backlog keeps moving even when the budget is spent before Low types run
+    static constexpr size_t DEADLINE_CHECK_INTERVAL = 32;
+
+    SubscriberList<EventHandler<E>> handlers;
+    SubscriberList<EventHandler<std::span<const E>>> batchHandlers;
+    std::unique_ptr<MpscQueue<E>> postQueue;    // Created by EventSystem::enablePosting<E>()
+
+private:
+    struct QueueBuffer {
+        E* events = nullptr;
+        uint32_t count = 0;
+        uint32_t capacity = 0;
+    };
+
+    /// Per-event handlers for each delivered event, then one span for batch subscribers
+    /// @return Events delivered (a prefix of events)
+    size_t deliver(const E* events, size_t count, const EventDeadline* deadline) {
+        size_t done = count;
+        if (!handlers.empty()) {
+            done = 0;
+            while (done < count) {
+                size_t end = deadline ? std::min(count, done + DEADLINE_CHECK_INTERVAL) : count;
+                for (; done < end; ++done) {
+                    handlers.forEach([&](const EventHandler<E>& handler) { handler(events[done]); });
+                }
+                if (deadline && deadline->expired()) break;
+            }
+        }
+        if (!batchHandlers.empty() && done > 0) {
+            deliverBatch(std::span<const E>(events, done));
+        }
+        return done;
+    }
+
+    QueueBuffer queued[2];
+    std::vector<E> backlog;     // Deferred Low priority events, oldest first
+
+    CoalescePolicy coalescePolicy = CoalescePolicy::None;
+    uint64_t (*coalesceKey)(const E&) = nullptr;
+    void (*coalesceMerge)(E&, const E&) = nullptr;
+    CoalesceTable coalesceTables[2];
+    uint64_t coalescedCount = 0;
+
+    std::atomic<uint64_t> posted{0};
+    std::atomic<uint64_t> dropped{0};
+    size_t highWater = 0;
+};
+
 /// EventSystem manages event dispatching and listening
 class EventSystem : public EntitySystem {
 public:
     EventSystem();
     ~EventSystem() override = default;
 
+    /// Subscribe to a typed event
+    /// @param fn - Callable taking const E&
+    /// @return Handle for unsubscribe() (safe to call from inside a handler)
+    template<TypedEvent E, typename Fn>
+    EventSubscription subscribe(Fn&& fn) {
+        EventSubscription subscription;
+        subscription.type = EventTypes::id<E>;
+        subscription.slot = getChannel<E>().handlers.add(EventHandler<E>(std::forward<Fn>(fn)),
+                                                         subscription.generation);
+        return subscription;
+    }
+
+    /// Subscribe to batches of a typed event
+    /// Queued events arrive once per processQueue() as one span (after the per-event handlers);
+    /// an immediate dispatch<E>() arrives as a span of one
+    /// @param fn - Callable taking std::span<const E>
+    template<TypedEvent E, typename Fn>
+    EventSubscription subscribeBatch(Fn&& fn) {
+        EventSubscription subscription;
+        subscription.type = EventTypes::id<E>;
+        subscription.slot = getChannel<E>().batchHandlers.add(
+            EventHandler<std::span<const E>>(std::forward<Fn>(fn)), subscription.generation);
+        subscription.slot |= EventChannel<E>::BATCH_SLOT;
+        return subscription;
+    }
+
+    /// Fold queued events of E that share a key within a frame (posted events included)
+    /// @param key - Identity of an event (e.g. entity id) as uint64_t; captureless lambda or function
+    /// @param merge - Accumulate only: fold the incoming event into the queued one
+    template<TypedEvent E>
+    void setCoalescing(CoalescePolicy policy, uint64_t (*key)(const E&) = nullptr,
+                       void (*merge)(E&, const E&) = nullptr) {
+        assert((policy == CoalescePolicy::None || key) && "Coalescing needs a key function");
+        assert((policy != CoalescePolicy::Accumulate || merge) && "Accumulate needs a merge function");
+        getChannel<E>().setCoalescing(policy, key, merge);
+    }
+
+    /// Events of E folded away by coalescing so far
+    template<TypedEvent E>
+    uint64_t getCoalescedCount() const {
+        const EventChannel<E>* channel = findChannel<E>();
+        return channel ? channel->getCoalescedCount() : 0;
+    }
+
+    /// Dispatch a typed event immediately to every handler of E
+    template<TypedEvent E>
+    void dispatch(const E& event) {
+        if (EventChannel<E>* channel = findChannel<E>()) {
+            channel->dispatch(event);
+        }
+    }
+
+    /// Queue a typed event (copied by value into this frame's arena) for processQueue()
+    /// Events queued while processQueue() runs are delivered on the next call.
+    template<TypedEvent E>
+    void queue(const E& event) {
+        static_assert(std::is_trivially_copyable_v<E> && std::is_trivially_destructible_v<E>,
+                      "Queued events live in a FrameArena and are never destroyed");
+        if (getChannel<E>().push(queueArenas[writeBuffer], writeBuffer, event)) {
+            queuedTypes[writeBuffer].push_back(EventTypes::id<E>);
+        }
+        ++queuedEventCount;
+    }
+
+    /// Check whether a typed event has any handler (skip building events nobody listens to)
+    template<TypedEvent E>
+    bool hasSubscribers() const {
+        const EventChannel<E>* channel = findChannel<E>();
+        return channel && channel->hasSubscribers();
+    }
+
     /// Subscribe to an event type
-    void subscribe(const std::string& eventType, const EventCallback& callback);
+    /// @return Handle for unsubscribe()
+    EventSubscription subscribe(const std::string& eventType, const EventCallback& callback);
 
-    /// Unsubscribe from an event type
-    void unsubscribe(const std::string& eventType, const EventCallback& callback);
+    /// Remove a subscription (typed or by name) - O(1), the handler is never called again
+    /// @return false if the handle was already unsubscribed
+    bool unsubscribe(const EventSubscription& subscription);
 
     /// Dispatch an event immediately
     void dispatch(const std::shared_ptr<EventData>& event);
@@ -42,14 +513,113 @@ public:
     /// Queue event for later dispatch
     void queue(const std::shared_ptr<EventData>& event);
 
+    /// Allow E to be posted from any thread through a bounded lock-free ring
+    /// Call on the main thread before any worker posts E (the ring is never resized)
+    /// @param capacity - Events the ring holds between two processQueue() calls
+    template<TypedEvent E>
+    void enablePosting(size_t capacity = 4096) {
+        EventChannel<E>& channel = getChannel<E>();
+        if (channel.postQueue) return;
+        channel.postQueue = std::make_unique<MpscQueue<E>>(capacity);
+        postableTypes.push_back(EventTypes::id<E>);
+    }
+
+    /// Post an event from any thread (no locks, no allocation)
+    /// Posted events join the queue at the next processQueue(), FIFO per producer
+    /// @return false if the event was dropped because the ring is full
+    template<TypedEvent E>
+    bool post(const E& event) {
+        EventChannel<E>* channel = findChannel<E>();
+        assert(channel && channel->postQueue && "enablePosting<E>() must be called before post<E>()");
+        return channel->post(event);
+    }
+
+    /// Set the delivery class of E (default Normal)
+    template<TypedEvent E>
+    void setPriority(EventPriority priority) {
+        getChannel<E>().priority = priority;
+    }
+
+    /// Limit the time processQueue() spends on Low priority events
+    /// High and Normal events (and the legacy queue) are always delivered; Low events get
+    /// what is left of the budget and the rest waits for the next frame.
+    /// @param milliseconds - Budget per processQueue() call, 0 for unlimited
+    void setFrameBudget(float milliseconds) { frameBudgetMs = milliseconds; }
+    float getFrameBudget() const { return frameBudgetMs; }
+
+    /// Low priority events carried over by the frame budget
+    const EventBacklogStats& getBacklogStats() const { return backlogStats; }
+
+    /// Backpressure counters for a postable type
+    template<TypedEvent E>
+    EventPostStats getPostStats() const {
+        const EventChannel<E>* channel = findChannel<E>();
+        return channel ? channel->getPostStats() : EventPostStats{};
+    }
+
     /// Process all queued events
+    /// Events posted from other threads are appended to their type's queue first.
+    /// Typed events are delivered type by type - High, Normal, then Low types (with a backlog
+    /// ahead of this frame's types), each class in order of the type's first queue() this
+    /// frame, FIFO within a type - then the legacy EventData queue
     void processQueue();
 
+    /// Typed events waiting for the next processQueue()
+    size_t getQueuedEventCount() const { return queuedEventCount; }
+
+    /// Arena bytes used by the typed events waiting for the next processQueue()
+    size_t getQueueArenaBytesUsed() const { return queueArenas[writeBuffer].getBytesUsed(); }
+
     void initialize() override;
     void shutdown() override;
     void update(float deltaTime) override;
 
 private:
-    std::map<std::string, std::vector<EventCallback>> subscribers;
+    template<typename E>
+    EventChannel<E>* findChannel() const {
+        const EventTypeId id = EventTypes::id<E>;
+        return id < channels.size() ? static_cast<EventChannel<E>*>(channels[id].get()) : nullptr;
+    }
+
+    template<typename E>
+    EventChannel<E>& getChannel() {
+        // allocateId() never hands out an id past the table
+        const EventTypeId id = EventTypes::id<E>;
+        if (!channels[id]) {
+            channels[id] = std::make_unique<EventChannel<E>>();
+        }
+        return *static_cast<EventChannel<E>*>(channels[id].get());
+    }
+
+    // Fixed-size table (never reallocated) so post() may read it from worker threads
+    static constexpr size_t MAX_EVENT_TYPES = EventTypes::MAX_TYPES;
+    std::vector<std::unique_ptr<EventChannelBase>> channels;  // Indexed by EventTypeId
+    std::vector<EventTypeId> postableTypes;                   // Types with a post ring
+
+    // Typed queue, double buffered: processQueue() drains one buffer while handlers queue
+    // into the other; each buffer's arena is reset in O(1) once it has been drained
+    FrameArena queueArenas[2];
+    std::vector<EventTypeId> queuedTypes[2];    // Types with events in each buffer, first-queued order
+    uint32_t writeBuffer = 0;
+    size_t queuedEventCount = 0;
+
+    // Frame budget for Low priority delivery
+    float frameBudgetMs = 0.0f;
+    std::vector<EventTypeId> backlogTypes;      // Types left with a backlog by the last processQueue()
+    std::vector<EventTypeId> processOrder;      // Scratch: types to deliver this processQueue()
+    EventBacklogStats backlogStats;
+
+    // Legacy (string keyed) subscriptions: handle type is LEGACY_TYPE, slots index legacySubscriptions
+    // Records are recycled through freeLegacySlots; the handle generation guards reused records
+    static constexpr EventTypeId LEGACY_TYPE = UINT32_MAX - 1;
+    struct LegacySubscription {
+        std::string eventType;
+        uint32_t slot = 0;              // Slot in subscribers[eventType]
+        uint32_t generation = 0;        // Generation in subscribers[eventType]
+        uint32_t handleGeneration = 0;  // Bumped when the record is released
+    };
+    std::map<std::string, SubscriberList<EventHandler<std::shared_ptr<EventData>>>> subscribers;
+    std::vector<LegacySubscription> legacySubscriptions;
+    std::vector<uint32_t> freeLegacySlots;
     std::vector<std::shared_ptr<EventData>> eventQueue;
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/// Linear (bump) allocator for data that lives until the end of a frame
+/// Memory comes from large blocks that are kept across frames, so after the first
+/// frames have warmed it up no allocation reaches the heap. reset() only rewinds
+/// the bump pointer - nothing is destroyed, so store trivially destructible data only.
+class FrameArena {
+public:
+    /// @param blockSize - Bytes per block (larger requests get a dedicated block)
+    explicit FrameArena(size_t blockSize = 256 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// Allocate bytes aligned to alignment (power of two, at most MAX_ALIGNMENT)
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// Release every allocation at once (O(1), blocks are kept)
+    void reset() {
+        currentBlock = 0;
+        offset = 0;
+        bytesUsed = 0;
+    }
+
+    /// Bytes handed out since the last reset (including alignment padding)
+    size_t getBytesUsed() const { return bytesUsed; }
+
+    /// Bytes reserved in blocks
+    size_t getCapacity() const { return capacity; }
+
+    static constexpr size_t MAX_ALIGNMENT = 64;
+
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    size_t currentBlock = 0;    // Block being bumped
+    size_t offset = 0;          // Bump offset inside the current block
+    size_t bytesUsed = 0;
+    size_t capacity = 0;
+};
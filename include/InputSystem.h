@@ -2,14 +2,25 @@
 
 #include "EntitySystem.h"
 #include "World.h"
+#include <glm/glm.hpp>
 #include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
 
 // Forward declaration
 struct GLFWwindow;
+class CollisionSystem;
+class GameEntity;
+class RenderCollector;
 
 /// System that manages input processing for entities with InputComponent
 /// Following ECS pattern: System iterates over entities with specific components
 /// and processes their input events each frame
+/// Keyboard and mouse movement are broadcast; mouse button events are delivered only
+/// to the entity picked under the cursor when a CollisionSystem is set (the topmost
+/// drawn collider on the pick layers, mapped back to its entity through the storage's
+/// owner column)
 class InputSystem : public EntitySystem {
 public:
     explicit InputSystem(const std::string& name = "InputSystem");
@@ -28,12 +39,37 @@ public:
     /// Get the GLFW window
     GLFWwindow* getWindow() const { return window; }
 
+    /// Set the collision system used for mouse picking (broadcast mouse buttons when not set)
+    void setCollisionSystem(std::shared_ptr<CollisionSystem> system) { collisionSystem = system; }
+
+    /// Set the view-projection matrix used to unproject the cursor into the world
+    void setPickingProjection(const glm::mat4& viewProjection) { pickingProjection = viewProjection; }
+
+    /// Collision layers considered for picking
+    void setPickLayerMask(uint32_t mask) { pickLayerMask = mask; }
+
+    /// Render collector whose draw order resolves coplanar picks (without it the
+    /// highest slot - the most recently created collider - wins)
+    void setRenderCollector(std::shared_ptr<RenderCollector> collector) { renderCollector = collector; }
+
+    /// Entity whose collider is closest under the given cursor position (window coordinates)
+    /// Equally close colliders (coplanar quads) resolve to the one drawn last, i.e. on top
+    std::shared_ptr<GameEntity> pickEntity(double mouseX, double mouseY) const;
+
     /// Poll input events from GLFW and distribute to entities
     void pollInputEvents();
 
 private:
     std::weak_ptr<World> world;
     GLFWwindow* window = nullptr;
+    std::weak_ptr<CollisionSystem> collisionSystem;
+    std::weak_ptr<RenderCollector> renderCollector;
+    glm::mat4 pickingProjection = glm::mat4(1.0f);
+    uint32_t pickLayerMask = 0xFFFFFFFF;
+
+    // State changes detected this poll (key/button, action)
+    std::vector<std::pair<int, int>> keyChanges;
+    std::vector<std::pair<int, int>> mouseButtonChanges;
 
     // Track previous key states to detect state changes
     std::unordered_map<int, int> previousKeyStates;
@@ -81,6 +81,44 @@ public:
         }
     }
 
+    /// Overwrite count elements starting at element offset (DSA)
+    /// Grows the buffer first if the range ends past capacity, keeping its contents
+    void uploadRange(size_t offset, const T* data, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (bufferID == 0) {
+            initialize();
+        }
+
+        if (offset + count > capacity) {
+            reserve((offset + count) * 2);  // Double capacity
+        }
+        glNamedBufferSubData(bufferID, offset * sizeof(T), count * sizeof(T), data);
+    }
+
+    /// Grow to at least newCapacity elements, keeping the contents and the buffer ID
+    /// (attachments such as VAO bindings stay valid)
+    void reserve(size_t newCapacity) {
+        if (bufferID == 0) {
+            initialize(newCapacity);
+            return;
+        }
+        if (newCapacity <= capacity) {
+            return;
+        }
+
+        // Park the old contents in a scratch buffer while this one is reallocated
+        GLuint scratch = 0;
+        glCreateBuffers(1, &scratch);
+        glNamedBufferData(scratch, capacity * sizeof(T), nullptr, GL_STREAM_COPY);
+        glCopyNamedBufferSubData(bufferID, scratch, 0, 0, capacity * sizeof(T));
+        glNamedBufferData(bufferID, newCapacity * sizeof(T), nullptr, usage);
+        glCopyNamedBufferSubData(scratch, bufferID, 0, 0, capacity * sizeof(T));
+        glDeleteBuffers(1, &scratch);
+        capacity = newCapacity;
+    }
+
     /// Setup vertex attribute pointer for instanced rendering
     /// Call this after binding VAO (still requires traditional API as it's VAO-dependent)
     void setupAttribute(GLint componentsPerAttribute = 1, bool isInteger = true) {
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cmath>
+
+/// Mesh geometry: indexed triangle list in local space
+/// Meshes are shared between entities like materials; RenderSystem copies each one into its
+/// shared mesh pool the first time it is drawn, so the geometry must not change afterwards
+class Mesh {
+public:
+    Mesh(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices)
+        : vertices(std::move(vertices)), indices(std::move(indices)) {}
+
+    ~Mesh() = default;
+
+    // Geometry accessors
+    const std::vector<glm::vec3>& getVertices() const { return vertices; }
+    const std::vector<uint32_t>& getIndices() const { return indices; }
+
+    /// Unit quad from -0.5,-0.5 to +0.5,+0.5 (the default mesh)
+    static std::shared_ptr<Mesh> createQuad() {
+        return std::make_shared<Mesh>(
+            std::vector<glm::vec3>{
+                { 0.5f,  0.5f, 0.0f},  // top right
+                { 0.5f, -0.5f, 0.0f},  // bottom right
+                {-0.5f, -0.5f, 0.0f},  // bottom left
+                {-0.5f,  0.5f, 0.0f}   // top left
+            },
+            std::vector<uint32_t>{0, 1, 3, 1, 2, 3});
+    }
+
+    /// Regular polygon inscribed in the unit quad (triangle fan around the center)
+    /// @param sides - At least 3
+    static std::shared_ptr<Mesh> createRegularPolygon(uint32_t sides) {
+        sides = sides < 3 ? 3 : sides;
+        std::vector<glm::vec3> vertices;
+        std::vector<uint32_t> indices;
+        vertices.reserve(sides + 1);
+        indices.reserve(sides * 3);
+
+        vertices.emplace_back(0.0f, 0.0f, 0.0f);
+        for (uint32_t i = 0; i < sides; ++i) {
+            float angle = 6.28318530718f * static_cast<float>(i) / static_cast<float>(sides);
+            vertices.emplace_back(0.5f * std::sin(angle), 0.5f * std::cos(angle), 0.0f);
+        }
+        for (uint32_t i = 0; i < sides; ++i) {
+            indices.push_back(0);
+            indices.push_back(1 + (i + 1) % sides);
+            indices.push_back(1 + i);
+        }
+        return std::make_shared<Mesh>(std::move(vertices), std::move(indices));
+    }
+
+private:
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+};
+
+using MeshPtr = std::shared_ptr<Mesh>;
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Mesh.h"
+#include "VBO.h"
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+/// Command layout read by glMultiDrawElementsIndirect (GL 4.3+)
+struct DrawElementsIndirectCommand {
+    GLuint count;          // Index count of the mesh
+    GLuint instanceCount;
+    GLuint firstIndex;     // Mesh start in the shared index buffer
+    GLint baseVertex;      // Mesh start in the shared vertex buffer
+    GLuint baseInstance;   // First instance - offsets the per-instance attributes
+};
+
+/// Mesh registry: every registered mesh lives in one shared vertex buffer and one shared
+/// index buffer, so a whole instance set can be drawn with one multi-draw-indirect call
+/// (one command per mesh) and one VAO. Meshes are appended, never removed.
+class MeshPool {
+public:
+    using MeshID = uint32_t;
+
+    /// Where a mesh lives in the shared buffers
+    struct MeshRange {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        int32_t baseVertex = 0;
+    };
+
+    MeshPool() = default;
+    ~MeshPool();
+
+    /// Prevent copying
+    MeshPool(const MeshPool&) = delete;
+    MeshPool& operator=(const MeshPool&) = delete;
+
+    /// Create the shared buffers (they grow as meshes are registered, keeping their IDs)
+    void initialize(size_t vertexCapacity = 1024, size_t indexCapacity = 4096);
+
+    /// Append a mesh to the shared buffers, or return its ID if it is already registered
+    /// Meshes are deduplicated by pointer; the pool keeps registered meshes alive.
+    /// @return Dense mesh ID (0, 1, 2, ...), INVALID_MESH for an empty mesh or uninitialized pool
+    MeshID registerMesh(const MeshPtr& mesh);
+
+    /// Location of a registered mesh
+    const MeshRange& getRange(MeshID id) const { return ranges[id]; }
+
+    /// Number of registered meshes (IDs are below this)
+    size_t getMeshCount() const { return ranges.size(); }
+
+    /// Vertices / indices used so far
+    size_t getVertexCount() const { return vertexCount; }
+    size_t getIndexCount() const { return indexCount; }
+
+    /// Shared buffers - attach to a VAO (binding of vec3 positions + element buffer)
+    GLuint getVertexBufferID() const { return vertexVBO ? vertexVBO->getBufferID() : 0; }
+    GLuint getIndexBufferID() const { return indexVBO ? indexVBO->getBufferID() : 0; }
+
+    /// Release the buffers and forget every mesh
+    void cleanup();
+
+    static constexpr MeshID INVALID_MESH = 0xFFFFFFFF;
+
+private:
+    std::unique_ptr<VBO<glm::vec3>> vertexVBO;   // Positions of every mesh
+    std::unique_ptr<VBO<uint32_t>> indexVBO;     // Indices of every mesh (relative to baseVertex)
+    std::vector<MeshRange> ranges;               // Indexed by mesh ID
+    std::unordered_map<MeshPtr, MeshID> meshToID;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CollisionDataStorage.h"
+#include "TransformDataStorage.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+class ThreadPool;
+
+/// Contact produced by the narrowphase for one overlapping pair
+struct Contact {
+    uint32_t a = 0;                         // CollisionDataStorage slots (a < b)
+    uint32_t b = 0;
+    glm::vec3 normal = glm::vec3(0.0f);     // Unit normal pointing from a to b
+    glm::vec3 point = glm::vec3(0.0f);      // Approximate contact point (world space)
+    float depth = 0.0f;                     // Penetration depth along the normal
+};
+
+/// Exact shape tests for broadphase candidate pairs, in the XY plane
+/// - Box: local AABB carried through the world matrix (OBB, separating axis test)
+/// - Circle: inscribed in the local AABB's XY footprint, radius scaled by the larger axis scale
+/// Slots without a bound transform use their world AABB as an axis-aligned box.
+/// Pairs are split into fixed chunks run on a ThreadPool; each chunk writes its own
+/// buffer and buffers are concatenated in chunk order, so the contact list is
+/// identical for any thread count.
+class Narrowphase {
+public:
+    Narrowphase() = default;
+
+    /// Generate contacts for the candidate pairs (outContacts is cleared first)
+    void run(const CollisionDataStorage& storage, const TransformDataStorage* transforms,
+             const std::vector<CollisionPair>& pairs, std::vector<Contact>& outContacts,
+             ThreadPool* pool = nullptr);
+
+    /// Get memory usage (bytes)
+    size_t getMemoryUsage() const {
+        size_t bytes = chunkContacts.capacity() * sizeof(std::vector<Contact>);
+        for (const auto& chunk : chunkContacts) {
+            bytes += chunk.capacity() * sizeof(Contact);
+        }
+        return bytes;
+    }
+
+private:
+    /// Shape in world space: center plus half-extent axes (box) or radius (circle)
+    struct WorldShape {
+        CollisionShape type;
+        glm::vec2 center;
+        glm::vec2 axisX;    // Box: half-extent vectors
+        glm::vec2 axisY;
+        float radius;       // Circle
+    };
+
+    static WorldShape makeWorldShape(const CollisionDataStorage& storage, const TransformDataStorage* transforms,
+                                     uint32_t slot);
+
+    static bool boxBox(const WorldShape& a, const WorldShape& b, Contact& contact);
+    static bool circleCircle(const WorldShape& a, const WorldShape& b, Contact& contact);
+    static bool boxCircle(const WorldShape& box, const WorldShape& circle, Contact& contact);
+
+    std::vector<std::vector<Contact>> chunkContacts;  // Per-chunk output
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CollisionDataStorage.h"
+#include <vector>
+#include <cstdint>
+
+/// Persistent set of overlapping pairs
+/// - Open addressing (linear probing) hash table keyed by the sorted slot pair,
+///   pointing into a dense pair array (iteration and removal never scan the table)
+/// - Per-slot partner lists, so the pairs touching a moved proxy are found without a scan
+/// - Incremental use: add() pairs found by querying moved proxies, prunePairs() the cached
+///   pairs of each moved proxy - untouched pairs cost nothing per frame
+/// - update() diffs a complete pair list instead (broadphases that regenerate every frame)
+/// Both paths report only transitions: pairs that started or stopped overlapping
+class PairCache {
+public:
+    PairCache() = default;
+
+    /// Insert a pair (order of a/b does not matter)
+    /// @return true if the pair was not cached yet (it starts overlapping)
+    bool add(uint32_t a, uint32_t b);
+
+    /// Remove every cached pair of slot for which keep(other) returns false
+    /// @param keep - bool(uint32_t otherSlot)
+    /// @param outEnds - Receives the removed pairs (appended)
+    template<typename Predicate>
+    void prunePairs(uint32_t slot, Predicate&& keep, std::vector<CollisionPair>& outEnds);
+
+    /// Merge a complete pair list (a < b, no duplicates) into the cache
+    /// @param outBegins - Receives pairs that were not present last frame (cleared first)
+    /// @param outEnds - Receives cached pairs missing from this frame (cleared first)
+    void update(const std::vector<CollisionPair>& pairs,
+                std::vector<CollisionPair>& outBegins, std::vector<CollisionPair>& outEnds);
+
+    /// Check whether a pair is currently overlapping (order of a/b does not matter)
+    bool contains(uint32_t a, uint32_t b) const;
+
+    /// Currently overlapping pairs (unordered)
+    const std::vector<CollisionPair>& getPairs() const { return pairs; }
+    size_t size() const { return pairs.size(); }
+
+    /// Number of cached pairs touching a slot
+    size_t getPartnerCount(uint32_t slot) const {
+        return slot < partners.size() ? partners[slot].size() : 0;
+    }
+
+    void clear();
+
+    /// Sort pairs by (a, b) - transition batches are sorted so listeners see a stable order
+    static void sortPairs(std::vector<CollisionPair>& pairs);
+
+    /// Get memory usage (bytes)
+    size_t getMemoryUsage() const {
+        size_t bytes = pairs.capacity() * sizeof(CollisionPair) +
+                       stamps.capacity() * sizeof(uint32_t) +
+                       table.capacity() * sizeof(uint32_t) +
+                       partners.capacity() * sizeof(std::vector<uint32_t>);
+        for (const auto& list : partners) {
+            bytes += list.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    static uint64_t makeKey(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    static uint64_t keyOf(const CollisionPair& pair) { return makeKey(pair.a, pair.b); }
+
+    uint32_t homeSlot(uint64_t key) const {
+        // Fibonacci hashing - top bits of the product index the table
+        return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - tableBits));
+    }
+
+    /// Table slot holding the key, or the empty slot where it would be inserted
+    uint32_t findSlot(uint64_t key) const;
+
+    /// Insert a sorted pair known to be absent at the given table slot
+    void insertAt(uint32_t slot, const CollisionPair& pair);
+
+    void grow();
+    void removeAt(uint32_t denseIndex);
+    void unlinkPartner(uint32_t slot, uint32_t other);
+
+    std::vector<CollisionPair> pairs;   // Dense live pairs
+    std::vector<uint32_t> stamps;       // Frame each pair was last reported (update() only)
+    std::vector<uint32_t> table;        // Dense index per slot, EMPTY when unused
+    std::vector<std::vector<uint32_t>> partners;  // Per storage slot, the other slot of each cached pair
+    uint32_t tableBits = 0;
+    uint32_t frame = 0;
+};
+
+template<typename Predicate>
+void PairCache::prunePairs(uint32_t slot, Predicate&& keep, std::vector<CollisionPair>& outEnds) {
+    if (slot >= partners.size()) return;
+
+    // Walk backwards - removal swap-erases the current entry with an already visited one
+    std::vector<uint32_t>& list = partners[slot];
+    for (size_t i = list.size(); i-- > 0;) {
+        uint32_t other = list[i];
+        if (keep(other)) continue;
+
+        CollisionPair pair = slot < other ? CollisionPair{slot, other} : CollisionPair{other, slot};
+        outEnds.push_back(pair);
+        removeAt(table[findSlot(keyOf(pair))]);
+    }
+}
@@ -3,6 +3,7 @@
 #include "EntitySystem.h"
 #include "RenderSystem.h"
 #include "Material.h"
+#include "TransformDataStorage.h"
 #include <glm/glm.hpp>
 #include <vector>
 #include <unordered_map>
@@ -10,6 +11,7 @@
 
 class World;
 class GameEntity;
+class TransformComputeSystem;
 
 /// Collector module that gathers RenderComponent data from all entities
 /// and prepares it for batch rendering with material deduplication
@@ -28,33 +30,86 @@ public:
     /// Set the render system to use for drawing
     void setRenderSystem(std::shared_ptr<RenderSystem> renderSys) { this->renderSystem = renderSys; }
 
+    /// GPU-driven transforms: movable world matrices are computed by this system from its
+    /// mirror of TransformDataStorage and read by the vertex shader where they are - the CPU
+    /// only syncs dirty TRS rows and writes one matrix ID per movable instance
+    /// nullptr (or a disabled/unavailable system) keeps the CPU gather path
+    void setTransformComputeSystem(std::shared_ptr<TransformComputeSystem> computeSys) { this->transformCompute = computeSys; }
+
     /// Collect all RenderComponent data and render
     void collectAndRender();
     
+    /// Position of a transform's instance in the frame's draw sequence - larger is drawn
+    /// later, i.e. on top (there is no depth test): the static set before the movable set,
+    /// each set in mesh ID order (one indirect command per mesh) - static instances in their
+    /// mesh bucket's order, movable instances in set order
+    /// @return 0 when the transform has no instance
+    uint64_t getDrawOrder(TransformDataStorage::HandleID handle) const;
+
     /// Mark data as needing rebuild (call when entities are added/removed)
+    /// Mobility changes do not need this - they are migrated per entity every frame
     void markDataDirty() { dataInitialized = false; }
 
 private:
+    enum class InstanceSet : uint8_t {
+        None,
+        Static,
+        Movable
+    };
+
+    /// Where the instance of a transform lives (indexed by transform handle index)
+    struct InstanceSlot {
+        uint32_t generation = 0;    // Transform handle generation the slot belongs to
+        uint32_t index = 0;         // Index in the static or movable arrays
+        InstanceSet set = InstanceSet::None;
+    };
+
+    /// Apply TransformDataStorage mobility changes since the last frame
+    void applyMobilityChanges(TransformDataStorage& storage, RenderSystem& renderSys);
+
+    /// Move a static instance to the end of the movable set
+    void migrateToMovable(uint32_t staticIndex, RenderSystem& renderSys);
+
+    /// Move a movable instance to the end of the static set
+    void migrateToStatic(uint32_t movableIndex, RenderSystem& renderSys);
+
+    /// Copy the movable world matrices into the mapped dynamic matrix buffer
+    void gatherMovableMatrices(TransformDataStorage& storage, RenderSystem& renderSys);
+
+    /// GPU-driven counterpart: sync + dispatch, then hand out storage rows as matrix IDs
+    void computeMovableMatrices(TransformDataStorage& storage, RenderSystem& renderSys,
+                                TransformComputeSystem& computeSys);
+
+    InstanceSlot* findSlot(TransformDataStorage::HandleID handle);
+    void setSlot(TransformDataStorage::HandleID handle, InstanceSet set, uint32_t index);
+
     std::weak_ptr<World> world;
     std::weak_ptr<RenderSystem> renderSystem;
+    std::weak_ptr<TransformComputeSystem> transformCompute;
 
     // Temporary buffers for batch data - separated by mobility
     // Static objects (never updated) - built once and cached
     std::vector<glm::mat4> staticModelMatrices;
     std::vector<unsigned int> staticMaterialIDs;
+    std::vector<unsigned int> staticMeshIDs;
     
-    // Movable objects (updated every frame) - only matrices change
-    std::vector<glm::mat4> movableModelMatrices;
+    // Movable objects (updated every frame) - matrices are gathered by handle from
+    // TransformDataStorage straight into the GPU buffer, only material IDs are kept here
     std::vector<unsigned int> movableMaterialIDs;  // Fixed, never changes
+    std::vector<unsigned int> movableMeshIDs;      // Fixed, never changes
     
     // Deduplicated materials - separated by mutability
     std::vector<MaterialPtr> uniqueStaticMaterials;  // Built once, never changes
     std::vector<MaterialPtr> uniqueDynamicMaterials;  // Built once, never changes
     std::unordered_map<MaterialPtr, unsigned int> materialToID;  // Built once, never changes
+    std::vector<MaterialPtr> materialsByID;  // Indexed by material ID (IDs span both mutabilities)
     
-    // Track which entities belong to which category (built once)
+    // Track which entities belong to which category (built once, then migrated per entity)
     std::vector<std::shared_ptr<GameEntity>> staticEntities;
     std::vector<std::shared_ptr<GameEntity>> movableEntities;
+    std::vector<TransformDataStorage::HandleID> staticHandles;   // Parallel to staticEntities
+    std::vector<TransformDataStorage::HandleID> movableHandles;  // Parallel to movableEntities
+    std::vector<InstanceSlot> instanceSlots;
     
     // Track if static data needs to be rebuilt
     bool dataInitialized = false;
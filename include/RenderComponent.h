@@ -2,10 +2,11 @@
 
 #include "GameEntity.h"
 #include "Material.h"
+#include "Mesh.h"
 #include <glm/glm.hpp>
 #include <string>
 
-/// Render component for 2D rectangle rendering with OpenGL
+/// Render component for 2D mesh rendering with OpenGL
 /// Stores rendering data only - actual rendering is done by RenderSystem
 class RenderComponent : public EntityComponent {
 public:
@@ -16,6 +17,11 @@ public:
     void setMaterial(MaterialPtr mat) { material = mat; }
     MaterialPtr getMaterial() const { return material; }
 
+    // Mesh accessors (nullptr = unit quad)
+    // Like materials, picked up when RenderCollector rebuilds (markDataDirty)
+    void setMesh(MeshPtr newMesh) { mesh = newMesh; }
+    MeshPtr getMesh() const { return mesh; }
+
     // Convenience color accessors (creates new material if needed)
     void setColor(const glm::vec4& color);
     glm::vec4 getColor() const;
@@ -28,5 +34,6 @@ public:
 
 private:
     MaterialPtr material;
+    MeshPtr mesh;
     bool isVisible = true;
 };
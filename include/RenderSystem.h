@@ -5,14 +5,19 @@
 #include "VAO.h"
 #include "SSBOBuffer.h"
 #include "InstanceVBO.h"
+#include "StreamingBuffer.h"
 #include "ShaderProgram.h"
+#include "MeshPool.h"
+#include "Mesh.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <vector>
 #include <memory>
 
-/// Dedicated rendering module for drawing 2D rectangles using SSBO-based rendering
+/// Dedicated rendering module for drawing 2D meshes using SSBO-based rendering
 /// Handles all OpenGL rendering operations
+/// Every mesh lives in one shared pool; each instance set (static, dynamic) is drawn with a
+/// single glMultiDrawElementsIndirect call - instances are grouped by mesh, one command per mesh
 class RenderSystem : public EntitySystem {
 public:
     RenderSystem(const std::string& name = "RenderSystem");
@@ -22,52 +27,152 @@ public:
     void update(float deltaTime) override;
     void shutdown() override;
 
-    /// Initialize OpenGL resources (shaders, VAO/VBO, SSBOs)
+    /// Initialize OpenGL resources (shaders, VAO/VBO, SSBOs, mesh pool)
     void initializeGL();
 
-    /// Render a batch of rectangles using dual SSBO/VBO architecture for static and dynamic data
+    /// Get the mesh ID to draw a mesh with, adding it to the shared mesh pool on first use
+    /// @return DEFAULT_MESH (unit quad) for nullptr, an empty mesh or before initializeGL()
+    MeshPool::MeshID registerMesh(const MeshPtr& mesh);
+
+    /// Shared mesh pool (mesh ranges, buffer sizes)
+    const MeshPool* getMeshPool() const { return meshPool.get(); }
+
+    /// Allocate this frame's dynamic matrices in the streaming buffer (write-only, mapped)
+    /// The caller writes all count matrices straight into GPU-visible memory, then calls
+    /// renderBatch() with count dynamic material IDs - renderBatch() draws and fences them.
+    /// @return nullptr if the allocation failed (the dynamic instances are skipped this frame)
+    glm::mat4* mapDynamicMatrices(size_t count);
+
+    /// GPU-driven alternative to mapDynamicMatrices(): the matrices already live on the GPU
+    /// Returns this frame's per-instance matrix IDs (count entries, CPU staging in instance
+    /// order); instance i is drawn with worldMatrices[ids[i]] read straight from worldMatrixSSBO
+    /// (e.g. the TransformComputeSystem output, indexed by transform storage row).
+    /// renderBatch() streams them in draw order, draws and fences as usual.
+    /// @return nullptr if the allocation failed (the dynamic instances are skipped this frame)
+    unsigned int* mapDynamicMatrixIDs(size_t count, GLuint worldMatrixSSBO);
+
+    /// Render a batch of meshes using dual SSBO/VBO architecture for static and dynamic data
+    /// The dynamic matrices must have been written through mapDynamicMatrices() (or their IDs
+    /// through mapDynamicMatrixIDs()) beforehand.
     /// @param staticMatrices - Static/Stationary transform matrices
     /// @param staticMaterials - Static materials (colors)
     /// @param staticMaterialIDs - Material IDs for static instances
-    /// @param dynamicMatrices - Movable transform matrices
+    /// @param staticMeshIDs - Mesh IDs (registerMesh()) for static instances
     /// @param dynamicMaterials - Dynamic materials (colors)
     /// @param dynamicMaterialIDs - Material IDs for dynamic instances
+    /// @param dynamicMeshIDs - Mesh IDs (registerMesh()) for dynamic instances
     void renderBatch(const std::vector<glm::mat4>& staticMatrices,
                      const std::vector<glm::vec4>& staticMaterials,
                      const std::vector<unsigned int>& staticMaterialIDs,
-                     const std::vector<glm::mat4>& dynamicMatrices,
+                     const std::vector<unsigned int>& staticMeshIDs,
                      const std::vector<glm::vec4>& dynamicMaterials,
-                     const std::vector<unsigned int>& dynamicMaterialIDs);
+                     const std::vector<unsigned int>& dynamicMaterialIDs,
+                     const std::vector<unsigned int>& dynamicMeshIDs);
 
     /// Get shader program ID
     unsigned int getShaderProgram() const { return shaderProgram ? shaderProgram->id() : 0; }
+
+    /// Get the streaming buffer used for per-frame dynamic data (stall counters etc.)
+    const StreamingBuffer* getDynamicStream() const { return dynamicStream.get(); }
+
+    /// Get the 2D projection matrix (used to unproject the cursor for picking)
+    const glm::mat4& getProjectionMatrix() const { return projectionMatrix; }
     
     /// Mark static data as dirty, forcing re-upload on next render
     /// Call this when static/stationary objects change (added, removed, or marked dirty)
     void markStaticDataDirty() { staticDataUploaded = false; }
 
+    /// Append one static instance to the uploaded static buffers (slot = static instance count)
+    /// Costs one matrix (staged, flushed by the next renderBatch()), one entry of each ID
+    /// stream and the mesh's draw command - used to migrate single instances between the
+    /// static and dynamic sets without re-uploading the static set. Falls back to a full
+    /// regroup in the next renderBatch() when the mesh's bucket is full or new.
+    /// Ignored until the static data has been uploaded once (the full upload covers it).
+    void addStaticInstance(size_t index, const glm::mat4& matrix, unsigned int materialID, unsigned int meshID);
+
+    /// Swap-remove one static instance, mirroring the caller's arrays: the last instance
+    /// takes over slot index. Same cost as addStaticInstance() - the gap in the mesh's bucket
+    /// is closed with the bucket's last entry.
+    /// @param lastMatrix - Matrix of the last instance (unused when index is the last slot)
+    void removeStaticInstance(size_t index, const glm::mat4& lastMatrix);
+
+    /// Position of a static instance in the static draw (larger is drawn later)
+    size_t getStaticDrawPosition(size_t index) const {
+        return index < staticDrawPositions.size() ? staticDrawPositions[index] : index;
+    }
+
+    /// Mesh of instances without one (unit quad, always mesh ID 0)
+    static constexpr MeshPool::MeshID DEFAULT_MESH = 0;
+
 private:
+    /// Spare entries reserved at least per static mesh bucket
+    static constexpr uint32_t STATIC_BUCKET_SLACK = 16;
+
+    /// Group count instances by mesh: fills drawOrder (instance indices, mesh by mesh) and
+    /// drawCommands (one per used mesh, baseInstance = the mesh's first slot in drawOrder)
+    void buildDrawOrder(const std::vector<unsigned int>& meshIDs, size_t count);
+
+    /// Lay the static ID streams out as one bucket per mesh (with spare room) and upload the
+    /// streams and one command per registered mesh
+    void rebuildStaticLayout(const std::vector<unsigned int>& materialIDs,
+                             const std::vector<unsigned int>& meshIDs, size_t count);
+
+    /// Upload the ID stream entries at one static draw position
+    void writeStaticDrawEntry(uint32_t position);
+
+    /// Upload the draw command of one mesh's static bucket
+    void writeStaticCommand(uint32_t mesh);
 
     // OpenGL resources
     std::unique_ptr<ShaderProgram> shaderProgram;
     std::unique_ptr<VAO> staticVAO;   // VAO for static/stationary objects
     std::unique_ptr<VAO> dynamicVAO;  // VAO for dynamic/movable objects
-    std::unique_ptr<VBO<float>> vertexVBO;  // Vertex positions (shared)
+    std::unique_ptr<MeshPool> meshPool;     // Vertex positions + indices of every mesh (shared)
     
     // Static data resources (GL_STATIC_DRAW - rarely updated)
     std::unique_ptr<InstanceVBO<unsigned int>> staticMaterialIDVBO;    // Static material IDs
     std::unique_ptr<InstanceVBO<unsigned int>> staticMatrixIDVBO;      // Static matrix IDs
     std::unique_ptr<SSBOBuffer<glm::vec4>> staticMaterialSSBO;         // Static materials SSBO
-    std::unique_ptr<SSBOBuffer<glm::mat4>> staticMatrixSSBO;           // Static matrices SSBO
+    std::unique_ptr<SSBOBuffer<glm::mat4>> staticMatrixSSBO;           // Static matrices SSBO (by slot)
+    std::unique_ptr<VBO<DrawElementsIndirectCommand>> staticCommandBuffer;  // Static indirect commands
     
-    // Dynamic data resources (GL_DYNAMIC_DRAW - updated every frame)
-    std::unique_ptr<InstanceVBO<unsigned int>> dynamicMaterialIDVBO;   // Dynamic material IDs
-    std::unique_ptr<InstanceVBO<unsigned int>> dynamicMatrixIDVBO;     // Dynamic matrix IDs
+    // Dynamic data resources (rewritten every frame)
+    // Matrices, material IDs, matrix IDs and indirect commands are bump-allocated from a fenced,
+    // persistently mapped ring (triple buffered) and bound by offset - no glNamedBufferSubData,
+    // no implicit sync
+    std::unique_ptr<StreamingBuffer> dynamicStream;                    // Dynamic matrices + ID streams
     std::unique_ptr<SSBOBuffer<glm::vec4>> dynamicMaterialSSBO;        // Dynamic materials SSBO
-    std::unique_ptr<SSBOBuffer<glm::mat4>> dynamicMatrixSSBO;          // Dynamic matrices SSBO
+    GLintptr dynamicMatrixOffset = 0;                                  // This frame's matrices in dynamicStream
+    std::vector<unsigned int> dynamicMatrixIDs;                        // This frame's matrix IDs (GPU-driven mode)
+    GLuint dynamicMatrixSource = 0;                                    // GPU world matrix SSBO, 0 = streamed matrices
+    GLint ssboOffsetAlignment = 256;                                   // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
     
     bool glInitialized = false;
     bool staticDataUploaded = false;  // Track if static data has been uploaded (GL_STATIC_DRAW optimization)
+    bool staticDrawOrderDirty = true; // Static ID streams/commands must be regrouped by mesh
+    size_t staticSlotCount = 0;       // Static instances in the uploaded buffers
+    size_t mappedDynamicCount = 0;    // Matrices handed out by the last mapDynamicMatrices()
+
+    /// One mesh's range of the static ID streams: [base, base + count) is drawn by the
+    /// mesh's command, up to capacity entries are reserved so that adding an instance
+    /// does not move the other buckets
+    struct StaticBucket {
+        uint32_t base = 0;
+        uint32_t count = 0;
+        uint32_t capacity = 0;
+    };
+
+    // Static layout (rebuildStaticLayout, patched by addStaticInstance/removeStaticInstance)
+    std::vector<StaticBucket> staticBuckets;      // By mesh ID - one command each
+    std::vector<uint32_t> staticSlotMeshes;       // Per static slot: mesh ID
+    std::vector<uint32_t> staticSlotMaterials;    // Per static slot: material ID
+    std::vector<uint32_t> staticDrawPositions;    // Per static slot: entry in the ID streams
+    std::vector<uint32_t> staticDrawSlots;        // Per ID stream entry: static slot
+
+    // Mesh grouping scratch (buildDrawOrder, rebuildStaticLayout)
+    std::vector<uint32_t> drawOrder;
+    std::vector<DrawElementsIndirectCommand> drawCommands;
+    std::vector<uint32_t> meshFirstSlots;
 
     // Projection matrix for 2D rendering
     glm::mat4 projectionMatrix;
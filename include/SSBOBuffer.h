@@ -3,11 +3,16 @@
 #include <GL/glew.h>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 
 /// Encapsulated SSBO (Shader Storage Buffer Object) class using DSA (Direct State Access) API
 /// Simplifies buffer management with automatic resizing and usage hint support
 /// Uses modern OpenGL 4.5+ DSA functions for stateless, efficient buffer operations
 /// Supports persistent mapped buffers (OpenGL 4.4+) for zero-copy updates
+/// (mapped with explicit flushing - every write path flushes exactly the range it wrote)
+/// write()/flush() stage element-wise updates and upload only the coalesced dirty ranges
+/// Persistent buffers grow by moving to new immutable storage - the buffer ID changes and the
+/// old storage stays alive behind a fence until the GPU has finished with it
 template<typename T>
 class SSBOBuffer {
 public:
@@ -31,10 +36,13 @@ public:
     SSBOBuffer(SSBOBuffer&& other) noexcept
         : bufferID(other.bufferID), bindingPoint(other.bindingPoint),
           usage(other.usage), capacity(other.capacity),
-          usePersistentMapping(other.usePersistentMapping), mappedPtr(other.mappedPtr) {
+          usePersistentMapping(other.usePersistentMapping), mappedPtr(other.mappedPtr),
+          writeMappedPtr(other.writeMappedPtr), retiredBuffers(std::move(other.retiredBuffers)),
+          shadow(std::move(other.shadow)), dirtyRanges(std::move(other.dirtyRanges)) {
         other.bufferID = 0;
         other.capacity = 0;
         other.mappedPtr = nullptr;
+        other.writeMappedPtr = nullptr;
     }
 
     SSBOBuffer& operator=(SSBOBuffer&& other) noexcept {
@@ -46,9 +54,14 @@ public:
             capacity = other.capacity;
             usePersistentMapping = other.usePersistentMapping;
             mappedPtr = other.mappedPtr;
+            writeMappedPtr = other.writeMappedPtr;
+            retiredBuffers = std::move(other.retiredBuffers);
+            shadow = std::move(other.shadow);
+            dirtyRanges = std::move(other.dirtyRanges);
             other.bufferID = 0;
             other.capacity = 0;
             other.mappedPtr = nullptr;
+            other.writeMappedPtr = nullptr;
         }
         return *this;
     }
@@ -59,23 +72,22 @@ public:
             return;  // Already initialized
         }
 
-        capacity = initialCapacity;
-        
-        // DSA: Create buffer directly without binding
-        glCreateBuffers(1, &bufferID);
+        capacity = std::max<size_t>(initialCapacity, 1);
         
         if (usePersistentMapping) {
             // Use persistent mapped buffer (GL 4.4+)
-            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-            glNamedBufferStorage(bufferID, capacity * sizeof(T), nullptr, flags);
-            
-            // Map the buffer persistently
-            mappedPtr = static_cast<T*>(glMapNamedBufferRange(bufferID, 0, capacity * sizeof(T), flags));
+            bufferID = createPersistentStorage(capacity, mappedPtr);
             
             if (!mappedPtr) {
-                usePersistentMapping = false;  // Fallback to traditional
+                // Fallback to traditional (immutable storage cannot be reallocated)
+                glDeleteBuffers(1, &bufferID);
+                usePersistentMapping = false;
             }
-        } else {
+        }
+        if (!usePersistentMapping) {
+            // DSA: Create buffer directly without binding
+            glCreateBuffers(1, &bufferID);
+
             // Traditional buffer
             // DSA: Allocate buffer storage directly
             glNamedBufferData(bufferID, capacity * sizeof(T), nullptr, usage);
@@ -83,23 +95,25 @@ public:
     }
 
     /// Upload data to the SSBO (DSA)
-    /// Automatically resizes if needed
+    /// Automatically resizes if needed. Discards writes staged since the last flush().
     void uploadData(const std::vector<T>& data) {
         if (bufferID == 0) {
             initialize();
         }
+        dirtyRanges.clear();
 
         // Handle persistent mapped buffers
         if (usePersistentMapping && mappedPtr) {
+            releaseRetiredBuffers();
             if (data.size() > capacity) {
-                // Cannot resize persistent mapped buffers
-                return;
+                // Everything is overwritten below - nothing to carry over
+                growPersistent(std::max(data.size(), capacity * 2), 0);
             }
             
-            if (!data.empty()) {
+            if (!data.empty() && data.size() <= capacity) {
                 // Zero-copy: Direct memory write to mapped buffer
                 std::memcpy(mappedPtr, data.data(), data.size() * sizeof(T));
-                // No explicit sync needed with GL_MAP_COHERENT_BIT
+                glFlushMappedNamedBufferRange(bufferID, 0, data.size() * sizeof(T));
             }
         } else {
             // Traditional path: Resize if needed
@@ -118,6 +132,187 @@ public:
         }
     }
 
+    /// Overwrite count elements starting at element offset (DSA)
+    /// Grows the buffer first if the range ends past capacity, keeping its contents
+    void uploadRange(size_t offset, const T* data, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (bufferID == 0) {
+            initialize();
+        }
+
+        if (usePersistentMapping && mappedPtr) {
+            releaseRetiredBuffers();
+            if (offset + count > capacity) {
+                growPersistent(std::max(offset + count, capacity * 2), capacity);
+            }
+            if (offset + count <= capacity) {
+                std::memcpy(mappedPtr + offset, data, count * sizeof(T));
+                glFlushMappedNamedBufferRange(bufferID, offset * sizeof(T), count * sizeof(T));
+            }
+            return;
+        }
+
+        if (offset + count > capacity) {
+            reserve((offset + count) * 2);  // Double capacity
+        }
+        glNamedBufferSubData(bufferID, offset * sizeof(T), count * sizeof(T), data);
+    }
+
+    /// Stage one element - uploaded by the next flush()
+    void write(size_t index, const T& value) {
+        write(index, &value, 1);
+    }
+
+    /// Stage count elements starting at element offset - uploaded by the next flush()
+    /// Persistent buffers are written in place (growing first if needed); the others keep
+    /// a CPU copy of the written elements until flush() sends them
+    void write(size_t offset, const T* data, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (bufferID == 0) {
+            initialize();
+        }
+
+        if (usePersistentMapping && mappedPtr) {
+            if (offset + count > capacity) {
+                releaseRetiredBuffers();
+                growPersistent(std::max(offset + count, capacity * 2), capacity);
+                if (offset + count > capacity) {
+                    return;
+                }
+            }
+            std::memcpy(mappedPtr + offset, data, count * sizeof(T));
+        } else {
+            if (offset + count > shadow.size()) {
+                shadow.resize(offset + count);
+            }
+            std::copy(data, data + count, shadow.begin() + offset);
+        }
+        markDirty(offset, count);
+    }
+
+    /// Record count elements at offset as changed, merging with overlapping or adjacent ranges
+    /// Called by write(); call it directly after writing a persistent buffer's mapped pointer
+    void markDirty(size_t offset, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        DirtyRange merged{offset, offset + count};
+
+        // Ranges stay sorted and disjoint: absorb every range that touches the new one
+        auto first = std::lower_bound(dirtyRanges.begin(), dirtyRanges.end(), merged.begin,
+            [](const DirtyRange& range, size_t begin) { return range.end < begin; });
+        auto last = first;
+        while (last != dirtyRanges.end() && last->begin <= merged.end) {
+            merged.begin = std::min(merged.begin, last->begin);
+            merged.end = std::max(merged.end, last->end);
+            ++last;
+        }
+        first = dirtyRanges.erase(first, last);
+        dirtyRanges.insert(first, merged);
+    }
+
+    /// Send the staged ranges to the GPU (DSA): one glNamedBufferSubData per coalesced range,
+    /// or glFlushMappedNamedBufferRange per range for persistent buffers
+    void flush() {
+        if (dirtyRanges.empty()) {
+            return;
+        }
+
+        if (usePersistentMapping && mappedPtr) {
+            for (const DirtyRange& range : dirtyRanges) {
+                glFlushMappedNamedBufferRange(bufferID, range.begin * sizeof(T),
+                                              (range.end - range.begin) * sizeof(T));
+            }
+        } else {
+            size_t end = dirtyRanges.back().end;
+            if (end > capacity) {
+                reserve(std::max(end, capacity * 2));  // Double capacity
+            }
+            for (const DirtyRange& range : dirtyRanges) {
+                glNamedBufferSubData(bufferID, range.begin * sizeof(T),
+                                     (range.end - range.begin) * sizeof(T), shadow.data() + range.begin);
+            }
+        }
+        dirtyRanges.clear();
+    }
+
+    /// Coalesced ranges waiting for flush()
+    size_t getDirtyRangeCount() const { return dirtyRanges.size(); }
+
+    /// Grow to at least newCapacity elements, keeping the contents and the buffer ID
+    /// (attachments such as VAO bindings stay valid)
+    /// Persistent buffers keep the contents but move to a new buffer ID (see growPersistent())
+    void reserve(size_t newCapacity) {
+        if (bufferID == 0) {
+            initialize(newCapacity);
+            return;
+        }
+        if (newCapacity <= capacity) {
+            return;
+        }
+        if (usePersistentMapping && mappedPtr) {
+            releaseRetiredBuffers();
+            growPersistent(newCapacity, capacity);
+            return;
+        }
+
+        // Park the old contents in a scratch buffer while this one is reallocated
+        GLuint scratch = 0;
+        glCreateBuffers(1, &scratch);
+        glNamedBufferData(scratch, capacity * sizeof(T), nullptr, GL_STREAM_COPY);
+        glCopyNamedBufferSubData(bufferID, scratch, 0, 0, capacity * sizeof(T));
+        glNamedBufferData(bufferID, newCapacity * sizeof(T), nullptr, usage);
+        glCopyNamedBufferSubData(scratch, bufferID, 0, 0, capacity * sizeof(T));
+        glDeleteBuffers(1, &scratch);
+        capacity = newCapacity;
+    }
+
+    /// Map the first count elements for writing (DSA) - the previous contents are discarded,
+    /// so the driver can hand out fresh storage instead of waiting for the GPU (orphaning)
+    /// Grows first if needed. Call unmap() before the buffer is used for drawing.
+    /// Persistent buffers return the mapped pointer (growing to new storage if needed).
+    T* mapForWrite(size_t count) {
+        if (bufferID == 0) {
+            initialize();
+        }
+        if (usePersistentMapping && mappedPtr) {
+            releaseRetiredBuffers();
+            if (count > capacity) {
+                growPersistent(std::max(count, capacity * 2), 0);
+            }
+            if (count > capacity) {
+                return nullptr;
+            }
+            markDirty(0, count);  // Flushed by unmap()
+            return mappedPtr;
+        }
+        if (count == 0) {
+            return nullptr;
+        }
+
+        if (count > capacity) {
+            capacity = count * 2;  // Double capacity
+            glNamedBufferData(bufferID, capacity * sizeof(T), nullptr, usage);
+        }
+        writeMappedPtr = static_cast<T*>(glMapNamedBufferRange(bufferID, 0, count * sizeof(T),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        return writeMappedPtr;
+    }
+
+    /// Finish a mapForWrite() (flushes the written range for persistent buffers)
+    void unmap() {
+        if (writeMappedPtr) {
+            glUnmapNamedBuffer(bufferID);
+            writeMappedPtr = nullptr;
+        } else if (usePersistentMapping && mappedPtr) {
+            flush();
+        }
+    }
+
     /// Bind the SSBO to its binding point
     /// Note: glBindBufferBase still needed for shader binding (not part of DSA)
     void bind() const {
@@ -131,7 +326,7 @@ public:
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, 0);
     }
 
-    /// Get buffer ID
+    /// Get buffer ID (changes when a persistent buffer grows)
     GLuint getID() const { return bufferID; }
 
     /// Get binding point
@@ -151,13 +346,26 @@ public:
         return mappedPtr;
     }
 
+    /// Old persistent storages still waiting for their fence
+    size_t getRetiredBufferCount() const { return retiredBuffers.size(); }
+
     /// Cleanup resources
     void cleanup() {
+        // Deletion of storage the GPU still reads is deferred by the driver
+        for (const RetiredBuffer& retired : retiredBuffers) {
+            glDeleteSync(retired.fence);
+            glDeleteBuffers(1, &retired.id);
+        }
+        retiredBuffers.clear();
+        dirtyRanges.clear();
+        shadow.clear();
+
         if (bufferID != 0) {
-            // Unmap if persistently mapped
-            if (mappedPtr) {
+            // Unmap if persistently mapped (or mapped by mapForWrite())
+            if (mappedPtr || writeMappedPtr) {
                 glUnmapNamedBuffer(bufferID);
                 mappedPtr = nullptr;
+                writeMappedPtr = nullptr;
             }
             
             glDeleteBuffers(1, &bufferID);
@@ -167,10 +375,89 @@ public:
     }
 
 private:
+    /// Storage replaced by growPersistent() - deleted once the GPU passes the fence
+    struct RetiredBuffer {
+        GLuint id;
+        GLsync fence;
+    };
+
+    /// Element range [begin, end) written since the last flush()
+    struct DirtyRange {
+        size_t begin;
+        size_t end;
+    };
+
+    /// Create immutable storage for count elements and map it persistently (DSA)
+    /// Not coherent: writes become visible to the GPU through glFlushMappedNamedBufferRange
+    static GLuint createPersistentStorage(size_t count, T*& mapped) {
+        const GLbitfield storageFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+        GLuint id = 0;
+        glCreateBuffers(1, &id);
+        glNamedBufferStorage(id, count * sizeof(T), nullptr, storageFlags);
+        mapped = static_cast<T*>(glMapNamedBufferRange(id, 0, count * sizeof(T),
+            storageFlags | GL_MAP_FLUSH_EXPLICIT_BIT));
+        return id;
+    }
+
+    /// Move to new immutable storage of newCapacity elements (storage cannot be resized in place)
+    /// Copies the first preserveCount elements on the GPU, re-binds the binding point if it
+    /// referenced the old buffer, and fences the old buffer because draws/dispatches already
+    /// submitted may still read it
+    void growPersistent(size_t newCapacity, size_t preserveCount) {
+        // The GPU-side copy only sees flushed writes; without a copy staged writes are void
+        if (preserveCount > 0) {
+            flush();
+        } else {
+            dirtyRanges.clear();
+        }
+
+        T* newMappedPtr = nullptr;
+        GLuint newID = createPersistentStorage(newCapacity, newMappedPtr);
+        if (!newMappedPtr) {
+            glDeleteBuffers(1, &newID);
+            return;  // Keep the old storage - callers check capacity
+        }
+        if (preserveCount > 0) {
+            glCopyNamedBufferSubData(bufferID, newID, 0, 0, preserveCount * sizeof(T));
+        }
+
+        GLint boundID = 0;
+        glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, bindingPoint, &boundID);
+
+        glUnmapNamedBuffer(bufferID);
+        retiredBuffers.push_back({bufferID, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+
+        bufferID = newID;
+        mappedPtr = newMappedPtr;
+        capacity = newCapacity;
+        if (static_cast<GLuint>(boundID) == retiredBuffers.back().id) {
+            bind();
+        }
+    }
+
+    /// Delete retired storages whose fence has signaled (never blocks)
+    void releaseRetiredBuffers() {
+        auto signaled = [](const RetiredBuffer& retired) {
+            GLenum result = glClientWaitSync(retired.fence, 0, 0);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return false;
+            }
+            glDeleteSync(retired.fence);
+            glDeleteBuffers(1, &retired.id);
+            return true;
+        };
+        retiredBuffers.erase(std::remove_if(retiredBuffers.begin(), retiredBuffers.end(), signaled),
+                             retiredBuffers.end());
+    }
+
     GLuint bufferID = 0;
     GLuint bindingPoint = 0;
     GLenum usage = GL_DYNAMIC_DRAW;
     size_t capacity = 0;
     bool usePersistentMapping = false;
     T* mappedPtr = nullptr;
+    T* writeMappedPtr = nullptr;  // Between mapForWrite() and unmap()
+    std::vector<RetiredBuffer> retiredBuffers;
+    std::vector<T> shadow;                 // Staged elements of non-persistent buffers (write())
+    std::vector<DirtyRange> dirtyRanges;   // Sorted, disjoint, non-adjacent
 };
@@ -38,6 +38,12 @@ public:
             glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(m));
         }
     }
+    void setUniformUInt(const char* name, GLuint value) const {
+        GLint loc = uniformLocation(name);
+        if (loc >= 0) {
+            glUniform1ui(loc, value);
+        }
+    }
 
     // Reset and delete program
     void reset();
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include <vector>
+#include <tuple>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/// Stable handle into a SoaTable: slot index plus generation
+/// Slots are recycled through a free list; the generation is bumped on every
+/// removal so handles to removed rows are detected instead of aliasing a new row
+struct SoaHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != UINT32_MAX; }
+    bool operator==(const SoaHandle&) const = default;
+};
+
+/// Generic SOA table - one 64-byte aligned array per column, rows kept dense
+/// Columns are descriptor types:
+///   struct Position { using Type = glm::vec3; };
+///   struct Scale    { using Type = glm::vec3; static Type initial() { return glm::vec3(1.0f); } };
+/// The descriptor names the column at compile time (column<Position>() is a span of glm::vec3),
+/// so two columns may share a value type. initial() is optional (value-initialized otherwise -
+/// glm types are not, so glm columns should provide it).
+/// - create() appends a row, destroy() swap-removes it: rows stay contiguous for batch loops
+/// - Handles stay valid across removals; rowOf() maps a handle to its current row
+/// - Every column grows together (doubling, MIN_CAPACITY rows minimum)
+template<typename... Columns>
+class SoaTable {
+public:
+    static_assert(sizeof...(Columns) > 0, "SoaTable needs at least one column");
+
+    static constexpr uint32_t INVALID_ROW = UINT32_MAX;
+    static constexpr size_t MIN_CAPACITY = 64;
+
+    template<typename T>
+    using ColumnVector = std::vector<T, AlignedAllocator<T, 64>>;
+
+    /// Append a row initialized from each column's initial() value
+    SoaHandle create() {
+        if (size() == capacity()) {
+            reserve(capacity() < MIN_CAPACITY ? MIN_CAPACITY : capacity() * 2);
+        }
+
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slotToRow.size());
+            slotToRow.push_back(INVALID_ROW);
+            generations.push_back(0);
+        }
+
+        uint32_t row = static_cast<uint32_t>(rowToSlot.size());
+        (vectorOf<Columns>().push_back(initialValue<Columns>()), ...);
+        rowToSlot.push_back(slot);
+        slotToRow[slot] = row;
+        return SoaHandle{slot, generations[slot]};
+    }
+
+    /// Remove a row; the last row is moved into its place
+    /// @return false if the handle was already stale
+    bool destroy(SoaHandle handle) {
+        if (!isAlive(handle)) return false;
+
+        uint32_t row = slotToRow[handle.index];
+        uint32_t last = static_cast<uint32_t>(rowToSlot.size()) - 1;
+        if (row != last) {
+            (moveRow<Columns>(last, row), ...);
+            rowToSlot[row] = rowToSlot[last];
+            slotToRow[rowToSlot[row]] = row;
+        }
+        (vectorOf<Columns>().pop_back(), ...);
+        rowToSlot.pop_back();
+
+        slotToRow[handle.index] = INVALID_ROW;
+        ++generations[handle.index];
+        freeSlots.push_back(handle.index);
+        return true;
+    }
+
+    bool isAlive(SoaHandle handle) const {
+        return handle.index < slotToRow.size() && generations[handle.index] == handle.generation &&
+               slotToRow[handle.index] != INVALID_ROW;
+    }
+
+    /// Current row of a live handle
+    uint32_t rowOf(SoaHandle handle) const { return slotToRow[handle.index]; }
+
+    /// Handle owning a row
+    SoaHandle handleAt(size_t row) const {
+        uint32_t slot = rowToSlot[row];
+        return SoaHandle{slot, generations[slot]};
+    }
+
+    /// Slot index -> row (INVALID_ROW for free slots), for batch consumers that store slot indices
+    std::span<const uint32_t> getRows() const { return slotToRow; }
+
+    // === Typed column access ===
+
+    template<typename Column>
+    std::span<typename Column::Type> column() {
+        return vectorOf<Column>();
+    }
+
+    template<typename Column>
+    std::span<const typename Column::Type> column() const {
+        return vectorOf<Column>();
+    }
+
+    /// Element of a live handle's row
+    template<typename Column>
+    typename Column::Type& get(SoaHandle handle) {
+        return column<Column>()[slotToRow[handle.index]];
+    }
+
+    template<typename Column>
+    const typename Column::Type& get(SoaHandle handle) const {
+        return column<Column>()[slotToRow[handle.index]];
+    }
+
+    size_t size() const { return rowToSlot.size(); }
+    bool empty() const { return rowToSlot.empty(); }
+    size_t capacity() const { return rowToSlot.capacity(); }
+
+    /// Grow every column to at least rows (the single growth point of the table)
+    void reserve(size_t rows) {
+        (vectorOf<Columns>().reserve(rows), ...);
+        rowToSlot.reserve(rows);
+    }
+
+    /// Remove every row; outstanding handles become stale
+    void clear() {
+        for (uint32_t slot : rowToSlot) {
+            slotToRow[slot] = INVALID_ROW;
+            ++generations[slot];
+            freeSlots.push_back(slot);
+        }
+        (vectorOf<Columns>().clear(), ...);
+        rowToSlot.clear();
+    }
+
+    /// Get memory usage (bytes)
+    size_t getMemoryUsage() const {
+        size_t bytes = ((vectorOf<Columns>().capacity() * sizeof(typename Columns::Type)) + ...);
+        return bytes + (rowToSlot.capacity() + slotToRow.capacity() + generations.capacity() +
+                        freeSlots.capacity()) * sizeof(uint32_t);
+    }
+
+private:
+    template<typename Column>
+    static constexpr size_t indexOf() {
+        constexpr bool matches[] = {std::is_same_v<Column, Columns>...};
+        size_t index = sizeof...(Columns);
+        for (size_t i = 0; i < sizeof...(Columns); ++i) {
+            if (matches[i]) {
+                index = i;
+                break;
+            }
+        }
+        return index;
+    }
+
+    // Columns are looked up by descriptor position, so two columns may share a value type
+    template<typename Column>
+    ColumnVector<typename Column::Type>& vectorOf() {
+        static_assert(indexOf<Column>() < sizeof...(Columns), "Column is not part of this SoaTable");
+        return std::get<indexOf<Column>()>(columns);
+    }
+
+    template<typename Column>
+    const ColumnVector<typename Column::Type>& vectorOf() const {
+        static_assert(indexOf<Column>() < sizeof...(Columns), "Column is not part of this SoaTable");
+        return std::get<indexOf<Column>()>(columns);
+    }
+
+    template<typename Column>
+    static typename Column::Type initialValue() {
+        if constexpr (requires { Column::initial(); }) {
+            return Column::initial();
+        } else {
+            return typename Column::Type{};
+        }
+    }
+
+    template<typename Column>
+    void moveRow(uint32_t from, uint32_t to) {
+        auto& values = vectorOf<Column>();
+        values[to] = std::move(values[from]);
+    }
+
+    std::tuple<ColumnVector<typename Columns::Type>...> columns;
+    std::vector<uint32_t> rowToSlot;    // Dense row -> slot
+    std::vector<uint32_t> slotToRow;    // Slot -> dense row, INVALID_ROW when free
+    std::vector<uint32_t> generations;  // Per slot, bumped on removal
+    std::vector<uint32_t> freeSlots;    // Recycled slots (LIFO)
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/// Persistently mapped ring buffer for data the CPU rewrites every frame (DSA, GL 4.4+)
+/// The buffer is split into frameCount equal regions. Each frame bump-allocates from the next
+/// region and endFrame() fences the draws that read it. When the ring comes back around,
+/// beginFrame() waits on that region's fence (normally long signaled), so the CPU never writes
+/// memory the GPU may still be reading and the driver never has to synchronize behind our back.
+class StreamingBuffer {
+public:
+    /// Sub-allocation inside the current frame's region
+    struct Allocation {
+        void* data = nullptr;   // Write-only coherent mapping (nullptr if the region is full)
+        GLintptr offset = 0;    // Byte offset into getID() (glBindBufferRange / glBindVertexBuffer)
+        size_t size = 0;        // Bytes
+    };
+
+    /// @param regionSize - Initial bytes per frame region
+    /// @param frameCount - Regions in flight (3 = triple buffering)
+    explicit StreamingBuffer(size_t regionSize = 64 * 1024, uint32_t frameCount = 3);
+
+    /// Destructor - waits for the GPU and releases the buffer
+    ~StreamingBuffer();
+
+    /// Prevent copying
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+    /// Create and persistently map the buffer (frameCount * regionSize bytes)
+    void initialize();
+
+    /// Start writing the next region, waiting for the GPU to release it first
+    /// @param minBytes - Bytes this frame needs; if a region is smaller, every region grows
+    ///                   (geometric, after waiting for all regions in flight - rare)
+    void beginFrame(size_t minBytes = 0);
+
+    /// Bump-allocate bytes from the current region
+    /// @param alignment - Power of two (e.g. GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT for SSBO ranges)
+    Allocation allocate(size_t bytes, size_t alignment);
+
+    template<typename T>
+    T* allocate(size_t count, size_t alignment, GLintptr& offset) {
+        Allocation allocation = allocate(count * sizeof(T), alignment < alignof(T) ? alignof(T) : alignment);
+        offset = allocation.offset;
+        return static_cast<T*>(allocation.data);
+    }
+
+    /// Fence the current region - call after the last draw that reads this frame's allocations
+    void endFrame();
+
+    /// Get buffer ID
+    GLuint getID() const { return bufferID; }
+
+    /// Bytes per frame region
+    size_t getRegionSize() const { return regionSize; }
+
+    /// Regions in flight
+    uint32_t getFrameCount() const { return frameCount; }
+
+    /// Bytes allocated from the current region so far
+    size_t getFrameBytesUsed() const { return frameOffset; }
+
+    /// beginFrame() calls that had to block because the GPU still used the region
+    uint64_t getStallCount() const { return stallCount; }
+
+    /// Cleanup resources (waits for every region in flight)
+    void cleanup();
+
+    /// Region starts and sizes are multiples of this (covers every UBO/SSBO offset alignment)
+    static constexpr size_t REGION_ALIGNMENT = 256;
+
+private:
+    void createStorage();
+    void waitForRegion(uint32_t region);
+    void waitForAllRegions();
+
+    GLuint bufferID = 0;
+    std::byte* mappedPtr = nullptr;
+    size_t regionSize = 0;
+    uint32_t frameCount = 0;
+    uint32_t currentRegion = 0;
+    size_t frameOffset = 0;         // Bump offset inside the current region
+    bool frameOpen = false;
+    std::vector<GLsync> fences;     // Per region, set by endFrame()
+    uint64_t stallCount = 0;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/// Persistent worker pool for data-parallel loops (broadphase build/query, narrowphase)
+/// Workers sleep between jobs; the calling thread participates as thread index 0.
+/// Chunks are handed out dynamically, so results that must be deterministic should be
+/// written per chunk (indexed by begin / grainSize) and merged in chunk order.
+/// Not re-entrant: do not call parallelFor from inside a job.
+class ThreadPool {
+public:
+    /// @param workerCount - Number of background workers (0 = hardware threads - 1)
+    explicit ThreadPool(uint32_t workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Job signature: (begin, end, threadIndex), threadIndex in [0, getThreadCount())
+    using RangeFunction = std::function<void(size_t begin, size_t end, uint32_t threadIndex)>;
+
+    /// Run fn over [0, count) in chunks of grainSize and wait for completion
+    void parallelFor(size_t count, size_t grainSize, const RangeFunction& fn);
+
+    /// Number of threads that may run a job (workers + caller)
+    uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()) + 1; }
+
+    /// Number of chunks parallelFor will split count into
+    static size_t getChunkCount(size_t count, size_t grainSize) {
+        return grainSize == 0 ? 0 : (count + grainSize - 1) / grainSize;
+    }
+
+private:
+    void workerLoop(uint32_t threadIndex);
+    void runChunks(uint32_t threadIndex);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // Current job (published under mutex, read by workers after wake-up)
+    const RangeFunction* job = nullptr;
+    size_t jobCount = 0;
+    size_t jobGrain = 1;
+    std::atomic<size_t> nextBegin{0};
+    std::atomic<uint32_t> activeWorkers{0};
+    uint64_t jobGeneration = 0;
+    bool stopping = false;
+};
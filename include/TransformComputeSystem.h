@@ -3,15 +3,20 @@
 #include "EntitySystem.h"
 #include "SSBOBuffer.h"
 #include "ShaderProgram.h"
+#include "StreamingBuffer.h"
+#include "TransformDataStorage.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 /// GPU-driven flat hierarchy transform system using Compute Shaders
 /// Computes world matrices on GPU from TRS + parent index data
 /// Perfect for CPU粗粒度 + GPU细粒度 architecture
+/// GPU rows mirror TransformDataStorage rows: syncFromStorage() copies only dirty rows, and
+/// computeWorldMatrices() runs one dispatch per hierarchy level so parents are always done first.
 class TransformComputeSystem : public EntitySystem {
 public:
     TransformComputeSystem(const std::string& name = "TransformComputeSystem");
@@ -24,7 +29,15 @@ public:
     /// Initialize compute shader and GPU buffers
     void initializeGL();
 
-    /// Upload flat transform data (TRS + parent indices) to GPU
+    /// Mirror the storage's TRS and parent rows into the GPU buffers (GPU row = storage row)
+    /// Only rows flagged in getAllGpuDirty() are written: they are staged in a streaming ring
+    /// and scattered into the TRS buffers by a compute pass, ordered on the GPU behind the
+    /// previous frame's dispatches, so the CPU never waits for them. Everything is rewritten
+    /// (orphaning the buffers) when rows moved (getLayoutVersion() changed). Clears the flags
+    /// it consumed.
+    void syncFromStorage(TransformDataStorage& storage);
+
+    /// Upload flat transform data (TRS + parent indices) to GPU - replaces all rows
     /// @param positions - Entity positions
     /// @param rotations - Entity rotations (quaternions)
     /// @param scales - Entity scales
@@ -35,9 +48,22 @@ public:
                             const std::vector<uint32_t>& parentIndices);
 
     /// Dispatch compute shader to calculate world matrices on GPU
-    /// Result stored in worldMatrixSSBO, ready for rendering
+    /// Rows are sorted by hierarchy level on the CPU; each level is one dispatch over its own
+    /// row range, with a barrier in between (a level reads its parents' results). The final
+    /// barrier makes worldMatrixSSBO visible to the vertex shader.
     void computeWorldMatrices();
 
+    /// Read the computed world matrices back (stalls - validation and debugging only)
+    std::vector<glm::mat4> readWorldMatrices() const;
+
+    /// CPU reference for every storage row (glm TRS, parent world * local)
+    static std::vector<glm::mat4> computeReferenceMatrices(const TransformDataStorage& storage);
+
+    /// Compare the GPU results with computeReferenceMatrices() after syncFromStorage() and
+    /// computeWorldMatrices() - the shader follows the reference's operation order exactly
+    /// @return Number of rows that differ (0 = bit-exact up to signed zeros)
+    size_t validateAgainstReference(const TransformDataStorage& storage) const;
+
     /// Get computed world matrix SSBO (for binding to rendering)
     GLuint getWorldMatrixSSBO() const { 
         return worldMatrixSSBO ? worldMatrixSSBO->getID() : 0; 
@@ -46,6 +72,19 @@ public:
     /// Get number of transforms
     size_t getTransformCount() const { return transformCount; }
 
+    /// Row of worldMatrixSSBO that always holds the identity (one past the last transform)
+    /// Draws whose transform was destroyed point here until the collector drops them
+    uint32_t getIdentityRow() const { return static_cast<uint32_t>(transformCount); }
+
+    /// Hierarchy depth + 1 (compute dispatches per computeWorldMatrices())
+    uint32_t getLevelCount() const { return static_cast<uint32_t>(levelRanges.size()); }
+
+    /// Rows written by the last syncFromStorage()
+    size_t getLastSyncedRowCount() const { return lastSyncedRowCount; }
+
+    /// True once the compute program and buffers exist
+    bool isAvailable() const { return glInitialized; }
+
     /// Enable/disable GPU compute (for performance comparison)
     void setEnabled(bool enabled) { this->enabled = enabled; }
     bool isEnabled() const { return enabled; }
@@ -54,6 +93,9 @@ private:
     // Compute shader program
     std::unique_ptr<ShaderProgram> computeProgram;
 
+    // Scatters staged TRS rows into the input SSBOs (syncFromStorage() incremental path)
+    std::unique_ptr<ShaderProgram> scatterProgram;
+
     // Input SSBOs (CPU → GPU) - TRS data
     std::unique_ptr<SSBOBuffer<glm::vec4>> positionSSBO;      // Binding 0: vec3 positions (padded to vec4)
     std::unique_ptr<SSBOBuffer<glm::vec4>> rotationSSBO;      // Binding 1: vec4 rotations (quaternions)
@@ -63,6 +105,49 @@ private:
     // Output SSBO (GPU → Rendering) - Computed world matrices
     std::unique_ptr<SSBOBuffer<glm::mat4>> worldMatrixSSBO;   // Binding 4: mat4 world matrices
 
+    // Hierarchy levels (0 = root) - rebuilt on the CPU when a parent index changes
+    std::unique_ptr<SSBOBuffer<uint32_t>> levelRowSSBO;       // Binding 5: uint rows sorted by level
+
+    /// One dirty row as staged for the scatter pass (std430 layout, binding 6)
+    struct TransformUpload {
+        glm::vec4 position;
+        glm::vec4 rotation;
+        glm::vec4 scale;
+        uint32_t row;
+        uint32_t parent;
+        uint32_t padding[2];
+    };
+
+    // Dirty rows staged per frame (triple buffered, fenced per region)
+    std::unique_ptr<StreamingBuffer> uploadStream;
+    GLint ssboOffsetAlignment = 256;                          // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+
+    /// Rows [offset, offset + count) of levelRows belong to one level
+    struct LevelRange {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    /// Recompute the levels from parentRows, sort the rows by level and upload them
+    void updateLevels();
+
+    /// Grow the input SSBOs to hold count rows, keeping their contents (GPU-side copy)
+    void reserveRows(size_t count);
+
+    /// Size worldMatrixSSBO for the transforms plus the identity row and (re)write that row
+    void updateIdentityRow();
+
+    std::vector<uint32_t> parentRows;    // CPU copy of parentIndexSSBO
+    std::vector<uint32_t> rowLevels;     // Level per row
+    std::vector<uint32_t> levelRows;     // CPU copy of levelRowSSBO
+    std::vector<LevelRange> levelRanges; // Per level, into levelRows (dispatch ranges)
+    std::vector<uint32_t> dirtyRows;     // Scratch: rows staged by syncFromStorage()
+    bool levelsDirty = true;
+    bool storageSynced = false;          // syncFromStorage() has mirrored every row once
+    uint32_t syncedLayoutVersion = 0;    // TransformDataStorage::getLayoutVersion() at the last sync
+    size_t lastSyncedRowCount = 0;
+    size_t identityRow = SIZE_MAX;       // Row holding the identity matrix (== transformCount once written)
+
     size_t transformCount = 0;
     bool glInitialized = false;
     bool enabled = true;  // Enable GPU compute by default
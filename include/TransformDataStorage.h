@@ -1,106 +1,166 @@
 #pragma once
 
+#include "SoaTable.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
-#include <vector>
-#include <unordered_map>
+#include <glm/gtc/matrix_transform.hpp>
+#include <span>
 #include <functional>
+#include <vector>
 #include <cstdint>
 
 /// Optimized SOA storage for transform data
 /// Used by TransformComponentFB for better cache performance
+/// Rows are dense (SoaTable swap-removes on deallocate); handles are stable. Batch
+/// consumers index the getAll*() columns by row - getRow() maps a handle to its row.
 class TransformDataStorage {
 public:
-    using HandleID = uint32_t;
-    static constexpr HandleID INVALID_HANDLE = UINT32_MAX;
+    using HandleID = SoaHandle;
+    static constexpr HandleID INVALID_HANDLE{};
+
+    // Column descriptors
+    struct Position      { using Type = glm::vec3; static Type initial() { return glm::vec3(0.0f); } };
+    struct Rotation      { using Type = glm::quat; static Type initial() { return glm::quat(1.0f, 0.0f, 0.0f, 0.0f); } };
+    struct Scale         { using Type = glm::vec3; static Type initial() { return glm::vec3(1.0f); } };
+    struct WorldMatrix   { using Type = glm::mat4; static Type initial() { return glm::mat4(1.0f); } };
+    struct WorldVersion  { using Type = uint32_t; };
+    struct Parent        { using Type = HandleID; };
+    struct MatrixDirty   { using Type = uint8_t; static Type initial() { return 1; } };
+    struct Mobility      { using Type = uint8_t; static Type initial() { return 1; } };  // Default to Movable
+    struct GpuDirty      { using Type = uint8_t; static Type initial() { return 1; } };  // TRS/parent not yet mirrored to the GPU
+    struct ChangeLogged  { using Type = uint8_t; };  // Already in the world change list
+
+    using Table = SoaTable<Position, Rotation, Scale, WorldMatrix, WorldVersion, Parent, MatrixDirty, Mobility, GpuDirty, ChangeLogged>;
 
     /// Allocate space for a new transform
     HandleID allocate() {
-        HandleID id = static_cast<HandleID>(positions.size());
-        positions.emplace_back(0.0f);
-        rotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
-        scales.emplace_back(1.0f);
-        worldMatrices.emplace_back(1.0f);
-        parentHandles.push_back(INVALID_HANDLE);
-        matrixDirty.push_back(true);
-        mobility.push_back(1);  // Default to Movable
-        return id;
-    }
-
-    /// Free allocated space
+        return table.create();
+    }
+
+    /// Free allocated space - the last row is moved into the freed row
+    /// The dead handle is logged as a world change, so consumers bound to it notice
     void deallocate(HandleID id) {
-        if (id >= positions.size()) return;
-        
-        // Mark as unused but keep data (can be reused)
-        // For true removal, use compaction (defragmentation)
+        if (table.isAlive(id) && !table.get<ChangeLogged>(id)) {
+            worldChanges.push_back(id);
+        }
+        if (table.destroy(id)) {
+            ++layoutVersion;
+        }
     }
 
+    /// Check whether a handle still refers to a live transform
+    bool isValid(HandleID id) const { return table.isAlive(id); }
+
+    /// Row of a live handle in the getAll*() columns
+    uint32_t getRow(HandleID id) const { return table.rowOf(id); }
+
+    /// Handle owning a row
+    HandleID getHandle(size_t row) const { return table.handleAt(row); }
+
     // Position accessors - SOA optimized
     glm::vec3 getPosition(HandleID id) const {
-        return positions[id];
+        return table.get<Position>(id);
     }
 
     void setPosition(HandleID id, const glm::vec3& pos) {
-        positions[id] = pos;
-        matrixDirty[id] = true;
+        table.get<Position>(id) = pos;
+        table.get<MatrixDirty>(id) = 1;
+        table.get<GpuDirty>(id) = 1;
     }
 
     // Rotation accessors - SOA optimized
     glm::quat getRotation(HandleID id) const {
-        return rotations[id];
+        return table.get<Rotation>(id);
     }
 
     void setRotation(HandleID id, const glm::quat& rot) {
-        rotations[id] = rot;
-        matrixDirty[id] = true;
+        table.get<Rotation>(id) = rot;
+        table.get<MatrixDirty>(id) = 1;
+        table.get<GpuDirty>(id) = 1;
     }
 
     // Scale accessors - SOA optimized
     glm::vec3 getScale(HandleID id) const {
-        return scales[id];
+        return table.get<Scale>(id);
     }
 
     void setScale(HandleID id, const glm::vec3& scale) {
-        scales[id] = scale;
-        matrixDirty[id] = true;
+        table.get<Scale>(id) = scale;
+        table.get<MatrixDirty>(id) = 1;
+        table.get<GpuDirty>(id) = 1;
     }
 
     // Matrix accessors
     glm::mat4 getWorldMatrix(HandleID id) const {
-        return worldMatrices[id];
+        return table.get<WorldMatrix>(id);
     }
 
     void setWorldMatrix(HandleID id, const glm::mat4& matrix) {
-        worldMatrices[id] = matrix;
-        matrixDirty[id] = false;
+        table.get<WorldMatrix>(id) = matrix;
+        ++table.get<WorldVersion>(id);
+        table.get<MatrixDirty>(id) = 0;
+        logWorldChange(table.rowOf(id));
+    }
+
+    /// Incremented on every world matrix write - consumers that derive data from
+    /// the world matrix (e.g. collision bounds) compare against the version they last saw
+    uint32_t getWorldVersion(HandleID id) const {
+        return table.get<WorldVersion>(id);
     }
 
     // Parent relationship
     HandleID getParent(HandleID id) const {
-        return parentHandles[id];
+        return table.get<Parent>(id);
     }
 
     void setParent(HandleID id, HandleID parentId) {
-        parentHandles[id] = parentId;
-        matrixDirty[id] = true;
+        table.get<Parent>(id) = parentId;
+        table.get<MatrixDirty>(id) = 1;
+        table.get<GpuDirty>(id) = 1;
     }
 
     // Dirty flag
     bool isDirty(HandleID id) const {
-        return matrixDirty[id];
+        return table.get<MatrixDirty>(id) != 0;
     }
 
     void setDirty(HandleID id, bool dirty) {
-        matrixDirty[id] = dirty;
+        table.get<MatrixDirty>(id) = dirty ? 1 : 0;
     }
 
     // Mobility tracking (0 = Static, 1 = Movable)
     uint8_t getMobility(HandleID id) const {
-        return mobility[id];
+        return table.get<Mobility>(id);
     }
 
     void setMobility(HandleID id, uint8_t mobilityValue) {
-        mobility[id] = mobilityValue;
+        uint8_t& mobility = table.get<Mobility>(id);
+        if (mobility != mobilityValue) {
+            mobility = mobilityValue;
+            mobilityChanges.push_back(id);
+            logWorldChange(table.rowOf(id));
+        }
+    }
+
+    /// Handles whose mobility changed since the last clearMobilityChanges(), in change order
+    /// A handle may appear more than once and may no longer be valid - read the current value.
+    /// The render collector drains this once per frame to migrate instances between its sets.
+    std::span<const HandleID> getMobilityChanges() const { return mobilityChanges; }
+    void clearMobilityChanges() { mobilityChanges.clear(); }
+
+    /// Handles whose world matrix or mobility changed since the last clearWorldChanges(), and
+    /// handles destroyed since then. Each live handle appears at most once; entries may no
+    /// longer be valid. The collision
+    /// system drains this once per step to refresh only the bounds of transforms that moved.
+    std::span<const HandleID> getWorldChanges() const { return worldChanges; }
+    void clearWorldChanges() {
+        auto logged = table.column<ChangeLogged>();
+        for (HandleID id : worldChanges) {
+            if (table.isAlive(id)) {
+                logged[table.rowOf(id)] = 0;
+            }
+        }
+        worldChanges.clear();
     }
 
     // Batch operations - these are much faster with SOA!
@@ -108,15 +168,21 @@ public:
     /// Update only movable dirty transforms - optimized for Static/Movable separation
     /// Static objects are never updated after initialization
     void updateMovableDirtyMatrices(const std::function<void(HandleID, glm::vec3, glm::quat, glm::vec3)>& callback) {
+        auto dirty = table.column<MatrixDirty>();
+        auto mobility = table.column<Mobility>();
+        auto positions = table.column<Position>();
+        auto rotations = table.column<Rotation>();
+        auto scales = table.column<Scale>();
+
         // Only iterate through movable objects
-        for (size_t i = 0; i < matrixDirty.size(); ++i) {
+        for (size_t i = 0; i < dirty.size(); ++i) {
             // Skip static objects (mobility == 0)
             if (mobility[i] == 0) continue;
-            
-            if (matrixDirty[i]) {
+
+            if (dirty[i]) {
                 // Load from cache-friendly consecutive arrays
-                callback(static_cast<HandleID>(i), positions[i], rotations[i], scales[i]);
-                matrixDirty[i] = false;
+                callback(table.handleAt(i), positions[i], rotations[i], scales[i]);
+                dirty[i] = 0;
             }
         }
     }
@@ -125,53 +191,126 @@ public:
     /// Process all positions, then rotations, then scales
     /// NOTE: Prefer updateMovableDirtyMatrices() for better performance with Static/Movable separation
     void updateAllDirtyMatrices(const std::function<void(HandleID, glm::vec3, glm::quat, glm::vec3)>& callback) {
+        auto dirty = table.column<MatrixDirty>();
+        auto positions = table.column<Position>();
+        auto rotations = table.column<Rotation>();
+        auto scales = table.column<Scale>();
+
         // Iterate through all dirty flags
-        for (size_t i = 0; i < matrixDirty.size(); ++i) {
-            if (matrixDirty[i]) {
+        for (size_t i = 0; i < dirty.size(); ++i) {
+            if (dirty[i]) {
                 // Load from cache-friendly consecutive arrays
-                callback(static_cast<HandleID>(i), positions[i], rotations[i], scales[i]);
-                matrixDirty[i] = false;
+                callback(table.handleAt(i), positions[i], rotations[i], scales[i]);
+                dirty[i] = 0;
+            }
+        }
+    }
+
+    /// Recompute the world matrix of every dirty movable transform from its TRS and its
+    /// parent's world matrix (a dirty movable parent is recomputed first)
+    /// Batch counterpart of TransformComponent::getWorldMatrix() for consumers that read
+    /// getAllWorldMatrices() directly. Static rows are left alone (see updateMovableDirtyMatrices()).
+    /// @return Number of matrices recomputed
+    size_t updateMovableWorldMatrices() {
+        auto dirty = table.column<MatrixDirty>();
+        auto mobility = table.column<Mobility>();
+        size_t updated = 0;
+        for (size_t row = 0; row < dirty.size(); ++row) {
+            if (dirty[row] && mobility[row] != 0) {
+                updated += updateWorldMatrixRow(row);
             }
         }
+        return updated;
     }
 
-    /// Get all positions for batch processing
-    const std::vector<glm::vec3>& getAllPositions() const { return positions; }
-    std::vector<glm::vec3>& getAllPositions() { return positions; }
+    /// Get all positions for batch processing (indexed by row)
+    std::span<const glm::vec3> getAllPositions() const { return table.column<Position>(); }
+    std::span<glm::vec3> getAllPositions() { return table.column<Position>(); }
 
     /// Get all rotations for batch processing
-    const std::vector<glm::quat>& getAllRotations() const { return rotations; }
-    std::vector<glm::quat>& getAllRotations() { return rotations; }
+    std::span<const glm::quat> getAllRotations() const { return table.column<Rotation>(); }
+    std::span<glm::quat> getAllRotations() { return table.column<Rotation>(); }
 
     /// Get all scales for batch processing
-    const std::vector<glm::vec3>& getAllScales() const { return scales; }
-    std::vector<glm::vec3>& getAllScales() { return scales; }
+    std::span<const glm::vec3> getAllScales() const { return table.column<Scale>(); }
+    std::span<glm::vec3> getAllScales() { return table.column<Scale>(); }
 
     /// Get all world matrices for batch processing
-    const std::vector<glm::mat4>& getAllWorldMatrices() const { return worldMatrices; }
-    std::vector<glm::mat4>& getAllWorldMatrices() { return worldMatrices; }
+    std::span<const glm::mat4> getAllWorldMatrices() const { return table.column<WorldMatrix>(); }
+    std::span<glm::mat4> getAllWorldMatrices() { return table.column<WorldMatrix>(); }
+
+    /// Get all world matrix versions for batch processing
+    std::span<const uint32_t> getAllWorldVersions() const { return table.column<WorldVersion>(); }
+
+    /// Get all mobility values for batch processing (0 = Static, 1 = Movable)
+    std::span<const uint8_t> getAllMobility() const { return table.column<Mobility>(); }
+
+    /// Get all parent handles for batch processing
+    std::span<const HandleID> getAllParents() const { return table.column<Parent>(); }
+
+    /// Rows whose TRS or parent changed since a GPU mirror last copied them (set by the
+    /// setters and on creation, cleared by the mirror - see TransformComputeSystem)
+    std::span<uint8_t> getAllGpuDirty() { return table.column<GpuDirty>(); }
+
+    /// Incremented whenever rows move (deallocate swap-removes) - row-indexed mirrors such as
+    /// GPU buffers and parent row indices must be rebuilt when this changes
+    uint32_t getLayoutVersion() const { return layoutVersion; }
+
+    /// Direct access to the underlying table (typed columns, handle/row mapping)
+    const Table& getTable() const { return table; }
+    Table& getTable() { return table; }
 
-    size_t size() const { return positions.size(); }
+    size_t size() const { return table.size(); }
 
-    /// Clear all data
+    /// Clear all data (outstanding handles become invalid)
     void clear() {
-        positions.clear();
-        rotations.clear();
-        scales.clear();
-        worldMatrices.clear();
-        parentHandles.clear();
-        matrixDirty.clear();
-        mobility.clear();
+        table.clear();
+        mobilityChanges.clear();
+        worldChanges.clear();
+        ++layoutVersion;
     }
 
+    /// Get memory usage (bytes)
+    size_t getMemoryUsage() const { return table.getMemoryUsage(); }
+
 private:
-    // SOA - Separate Arrays for each component
+    /// World = parent world * T * R * S for one row, parents first (recursion depth = hierarchy depth)
+    size_t updateWorldMatrixRow(size_t row) {
+        auto dirty = table.column<MatrixDirty>();
+        dirty[row] = 0;  // Cleared up front so a parent cycle cannot recurse forever
+
+        size_t updated = 0;
+        glm::mat4 parentWorld(1.0f);
+        HandleID parent = table.column<Parent>()[row];
+        if (table.isAlive(parent)) {
+            uint32_t parentRow = table.rowOf(parent);
+            if (dirty[parentRow] && table.column<Mobility>()[parentRow] != 0) {
+                updated += updateWorldMatrixRow(parentRow);
+            }
+            parentWorld = table.column<WorldMatrix>()[parentRow];
+        }
+
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), table.column<Position>()[row]) *
+                          glm::mat4_cast(table.column<Rotation>()[row]) *
+                          glm::scale(glm::mat4(1.0f), table.column<Scale>()[row]);
+        table.column<WorldMatrix>()[row] = parentWorld * local;
+        ++table.column<WorldVersion>()[row];
+        logWorldChange(row);
+        return updated + 1;
+    }
+
+    void logWorldChange(size_t row) {
+        uint8_t& logged = table.column<ChangeLogged>()[row];
+        if (!logged) {
+            logged = 1;
+            worldChanges.push_back(table.handleAt(row));
+        }
+    }
+
+    // SOA - Separate Arrays for each component, 64-byte aligned
     // This layout is much more cache-friendly for batch operations
-    std::vector<glm::vec3> positions;        // 12 bytes each, consecutive
-    std::vector<glm::quat> rotations;        // 16 bytes each, consecutive
-    std::vector<glm::vec3> scales;           // 12 bytes each, consecutive
-    std::vector<glm::mat4> worldMatrices;    // 64 bytes each, consecutive
-    std::vector<HandleID> parentHandles;     // 4 bytes each, consecutive
-    std::vector<bool> matrixDirty;           // 1 byte each, consecutive
-    std::vector<uint8_t> mobility;           // 1 byte each, consecutive (0=Static, 1=Movable)
+    Table table;
+    std::vector<HandleID> mobilityChanges;
+    std::vector<HandleID> worldChanges;
+    uint32_t layoutVersion = 0;
 };
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "AABB.h"
+#include "CollisionDataStorage.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+class ThreadPool;
+
+/// Flat spatial-hash broadphase specialized for 2D worlds with similarly sized objects
+/// - Cells are hashed on (x, y); z only participates in the final overlap test
+/// - Cell lists are rebuilt each frame with a counting sort into one contiguous
+///   entry array (bucketStarts + entries), no per-cell containers
+/// - A pair shared by several cells is only reported from the cell containing the
+///   min corner of the two boxes' overlap, so no deduplication pass is needed
+/// - Build and pair query run on a ThreadPool; output order is deterministic
+class UniformGridBroadphase {
+public:
+    UniformGridBroadphase() = default;
+
+    /// Fix the cell size (<= 0 picks it from the AABB size distribution on every build)
+    void setCellSize(float size) { fixedCellSize = size; }
+    float getCellSize() const { return cellSize; }
+
+    /// Rebuild cell lists from all enabled, awake movable slots of the storage
+    void build(const CollisionDataStorage& storage, ThreadPool* pool = nullptr);
+
+    /// Generate layer/mask filtered overlap pairs from the last build
+    void findPairs(const CollisionDataStorage& storage, std::vector<CollisionPair>& outPairs,
+                   ThreadPool* pool = nullptr);
+
+    /// Query storage slots whose AABB overlaps the box (each reported once)
+    /// @param callback - bool(uint32_t storageIndex), return false to stop
+    template<typename Callback>
+    void queryAABB(const CollisionDataStorage& storage, const AABB& box, Callback&& callback) const;
+
+    size_t getObjectCount() const { return objects.size(); }
+    size_t getEntryCount() const { return entries.size(); }
+    size_t getBucketCount() const { return bucketCount; }
+
+    /// Get memory usage (bytes)
+    size_t getMemoryUsage() const {
+        return objects.capacity() * sizeof(uint32_t) +
+               ranges.capacity() * sizeof(CellRange) +
+               entryOffsets.capacity() * sizeof(uint32_t) +
+               entryBuckets.capacity() * sizeof(uint32_t) +
+               unsortedEntries.capacity() * sizeof(Entry) +
+               entries.capacity() * sizeof(Entry) +
+               bucketStarts.capacity() * sizeof(uint32_t) +
+               bucketCursors.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    struct CellRange {
+        int32_t x0, y0, x1, y1;
+    };
+
+    struct Entry {
+        uint32_t slot;    // Index into objects/ranges
+        int32_t cellX;
+        int32_t cellY;
+    };
+
+    float chooseCellSize(const CollisionDataStorage& storage) const;
+
+    int32_t toCell(float coordinate) const {
+        return static_cast<int32_t>(std::floor(coordinate * inverseCellSize));
+    }
+
+    uint32_t bucketOf(int32_t x, int32_t y) const {
+        uint32_t h = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u;
+        return h & (bucketCount - 1);
+    }
+
+    float fixedCellSize = 0.0f;
+    float cellSize = 1.0f;
+    float inverseCellSize = 1.0f;
+    uint32_t bucketCount = 0;
+
+    std::vector<uint32_t> objects;         // Enabled awake movable storage indices
+    std::vector<CellRange> ranges;         // Cell range per object
+    std::vector<uint32_t> entryOffsets;    // Prefix sum of cells per object
+    std::vector<uint32_t> entryBuckets;    // Bucket per unsorted entry
+    std::vector<Entry> unsortedEntries;    // Object order
+    std::vector<Entry> entries;            // Bucket order (counting sort output)
+    std::vector<uint32_t> bucketStarts;    // bucketCount + 1 offsets into entries
+    std::vector<uint32_t> bucketCursors;   // Scatter cursors
+    std::vector<std::vector<CollisionPair>> chunkPairs;  // Per-chunk pair output
+};
+
+template<typename Callback>
+void UniformGridBroadphase::queryAABB(const CollisionDataStorage& storage, const AABB& box, Callback&& callback) const {
+    if (bucketCount == 0 || objects.empty()) return;
+
+    int32_t qx0 = toCell(box.min.x), qy0 = toCell(box.min.y);
+    int32_t qx1 = toCell(box.max.x), qy1 = toCell(box.max.y);
+    for (int32_t cy = qy0; cy <= qy1; ++cy) {
+        for (int32_t cx = qx0; cx <= qx1; ++cx) {
+            uint32_t bucket = bucketOf(cx, cy);
+            for (uint32_t e = bucketStarts[bucket]; e < bucketStarts[bucket + 1]; ++e) {
+                const Entry& entry = entries[e];
+                if (entry.cellX != cx || entry.cellY != cy) continue;
+
+                // Report only from the first cell shared by the object and the query
+                const CellRange& range = ranges[entry.slot];
+                if (std::max(range.x0, qx0) != cx || std::max(range.y0, qy0) != cy) continue;
+
+                uint32_t index = objects[entry.slot];
+                if (!storage.getBounds(index).overlaps(box)) continue;
+                if (!callback(index)) return;
+            }
+        }
+    }
+}
@@ -56,6 +56,10 @@ public:
     void bindVertexBuffer(GLuint bindingPoint, GLuint bufferID, 
                          GLintptr offset, GLsizei stride);
     
+    /// Attach an index buffer (GL_ELEMENT_ARRAY_BUFFER is VAO state - bind the VAO first)
+    /// @param bufferID - OpenGL buffer ID
+    void bindElementBuffer(GLuint bufferID);
+    
     /// Set binding divisor (0 = per-vertex, 1 = per-instance)
     /// @param bindingPoint - Buffer binding point
     /// @param divisor - Divisor value
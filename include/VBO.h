@@ -4,19 +4,88 @@
 #include <vector>
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 
 /// Base template class for Vertex Buffer Objects using DSA (Direct State Access) API
 /// Provides automatic buffer creation, resizing, and cleanup
 /// Usage hint defaults to GL_STATIC_DRAW but can be customized
 /// Supports persistent mapped buffers (OpenGL 4.4+) for zero-copy updates
+/// Persistent buffers grow by moving to new immutable storage - the buffer ID changes (re-attach
+/// it to VAOs) and the old storage stays alive behind a fence until the GPU has finished with it
 template<typename T>
 class VBO {
 private:
+    /// Storage replaced by growPersistent() - deleted once the GPU passes the fence
+    struct RetiredBuffer {
+        GLuint id;
+        GLsync fence;
+    };
+
     GLuint bufferID = 0;
     GLenum usageHint;
     size_t capacity = 0;
     bool usePersistentMapping = false;
     T* mappedPtr = nullptr;
+    std::vector<RetiredBuffer> retiredBuffers;
+
+    /// Create immutable storage for count elements and map it persistently (DSA)
+    static GLuint createPersistentStorage(size_t count, T*& mapped) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLuint id = 0;
+        glCreateBuffers(1, &id);
+        glNamedBufferStorage(id, count * sizeof(T), nullptr, flags);
+        mapped = static_cast<T*>(glMapNamedBufferRange(id, 0, count * sizeof(T), flags));
+        return id;
+    }
+
+    /// Move to new immutable storage of newCapacity elements (storage cannot be resized in place)
+    /// The first preserveCount elements are copied over on the GPU. Re-binds GL_ARRAY_BUFFER if
+    /// it referenced the old buffer and fences the old buffer, since draws already submitted
+    /// may still read it
+    void growPersistent(size_t newCapacity, size_t preserveCount) {
+        T* newMappedPtr = nullptr;
+        GLuint newID = createPersistentStorage(newCapacity, newMappedPtr);
+        if (!newMappedPtr) {
+            std::cerr << "[VBO] Error: Failed to map grown buffer persistently" << std::endl;
+            glDeleteBuffers(1, &newID);
+            return;
+        }
+        std::cout << "[VBO] Growing persistent mapped buffer from " << capacity << " to "
+                  << newCapacity << std::endl;
+
+        GLint boundID = 0;
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &boundID);
+
+        preserveCount = std::min(preserveCount, capacity);
+        if (preserveCount > 0) {
+            glCopyNamedBufferSubData(bufferID, newID, 0, 0, preserveCount * sizeof(T));
+        }
+
+        glUnmapNamedBuffer(bufferID);
+        retiredBuffers.push_back({bufferID, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+
+        bufferID = newID;
+        mappedPtr = newMappedPtr;
+        capacity = newCapacity;
+        if (static_cast<GLuint>(boundID) == retiredBuffers.back().id) {
+            bind();
+        }
+    }
+
+    /// Delete retired storages whose fence has signaled (never blocks)
+    void releaseRetiredBuffers() {
+        auto signaled = [](const RetiredBuffer& retired) {
+            GLenum result = glClientWaitSync(retired.fence, 0, 0);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return false;
+            }
+            glDeleteSync(retired.fence);
+            glDeleteBuffers(1, &retired.id);
+            return true;
+        };
+        retiredBuffers.erase(std::remove_if(retiredBuffers.begin(), retiredBuffers.end(), signaled),
+                             retiredBuffers.end());
+    }
 
 public:
     /// Constructor with usage hint
@@ -39,27 +108,26 @@ public:
             return;
         }
 
-        capacity = initialCapacity;
-        
-        // DSA: Create buffer directly without binding
-        glCreateBuffers(1, &bufferID);
+        capacity = std::max<size_t>(initialCapacity, 1);
         
         if (usePersistentMapping) {
             // Use persistent mapped buffer (GL 4.4+)
-            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-            glNamedBufferStorage(bufferID, capacity * sizeof(T), nullptr, flags);
-            
-            // Map the buffer persistently
-            mappedPtr = static_cast<T*>(glMapNamedBufferRange(bufferID, 0, capacity * sizeof(T), flags));
+            bufferID = createPersistentStorage(capacity, mappedPtr);
             
             if (mappedPtr) {
                 std::cout << "[VBO] Initialized persistent mapped buffer with capacity " << capacity 
                           << " (" << (capacity * sizeof(T)) << " bytes)" << std::endl;
             } else {
+                // Fallback to traditional (immutable storage cannot be reallocated)
                 std::cerr << "[VBO] Error: Failed to map buffer persistently" << std::endl;
+                glDeleteBuffers(1, &bufferID);
                 usePersistentMapping = false;
             }
-        } else {
+        }
+        if (!usePersistentMapping) {
+            // DSA: Create buffer directly without binding
+            glCreateBuffers(1, &bufferID);
+
             // Traditional buffer
             glNamedBufferData(bufferID, capacity * sizeof(T), nullptr, usageHint);
             
@@ -76,12 +144,14 @@ public:
             return;
         }
 
-        // Note: Persistent mapped buffers cannot be resized
+        // Note: Persistent mapped buffers cannot be resized in place - they move to new storage
         if (usePersistentMapping && mappedPtr) {
+            releaseRetiredBuffers();
             if (data.size() > capacity) {
-                std::cerr << "[VBO] Error: Cannot resize persistent mapped buffer (capacity: " 
-                          << capacity << ", requested: " << data.size() << ")" << std::endl;
-                return;
+                growPersistent(std::max(data.size(), capacity * 2), 0);  // Grow by 2x
+                if (data.size() > capacity) {
+                    return;
+                }
             }
             
             // Zero-copy: Direct memory write to mapped buffer
@@ -103,6 +173,56 @@ public:
         }
     }
 
+    /// Overwrite count elements starting at element offset, keeping the rest of the contents
+    /// Grows the buffer first (2x) if the range ends past capacity
+    void uploadRange(size_t offset, const T* data, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (bufferID == 0) {
+            std::cerr << "[VBO] Error: Buffer not initialized" << std::endl;
+            return;
+        }
+
+        if (offset + count > capacity) {
+            reserve(std::max(offset + count, capacity * 2));  // Grow by 2x
+            if (offset + count > capacity) {
+                return;
+            }
+        }
+        if (usePersistentMapping && mappedPtr) {
+            std::memcpy(mappedPtr + offset, data, count * sizeof(T));
+        } else {
+            glNamedBufferSubData(bufferID, offset * sizeof(T), count * sizeof(T), data);
+        }
+    }
+
+    /// Grow to at least newCapacity elements, keeping the contents
+    /// Traditional buffers keep their ID (VAO attachments stay valid); persistent buffers
+    /// move to new storage (the ID changes)
+    void reserve(size_t newCapacity) {
+        if (bufferID == 0 || newCapacity <= capacity) {
+            return;
+        }
+
+        if (usePersistentMapping && mappedPtr) {
+            releaseRetiredBuffers();
+            growPersistent(newCapacity, capacity);
+            return;
+        }
+
+        // Park the old contents in a scratch buffer while this one is reallocated
+        std::cout << "[VBO] Resizing buffer from " << capacity << " to " << newCapacity << std::endl;
+        GLuint scratch = 0;
+        glCreateBuffers(1, &scratch);
+        glNamedBufferData(scratch, capacity * sizeof(T), nullptr, GL_STREAM_COPY);
+        glCopyNamedBufferSubData(bufferID, scratch, 0, 0, capacity * sizeof(T));
+        glNamedBufferData(bufferID, newCapacity * sizeof(T), nullptr, usageHint);
+        glCopyNamedBufferSubData(scratch, bufferID, 0, 0, capacity * sizeof(T));
+        glDeleteBuffers(1, &scratch);
+        capacity = newCapacity;
+    }
+
     /// Bind buffer to target (traditional API - needed for some operations like vertex attrib setup)
     /// @param target - Buffer target (GL_ARRAY_BUFFER, etc.)
     void bind(GLenum target = GL_ARRAY_BUFFER) const {
@@ -117,6 +237,13 @@ public:
 
     /// Clean up buffer resources
     void cleanup() {
+        // Deletion of storage the GPU still reads is deferred by the driver
+        for (const RetiredBuffer& retired : retiredBuffers) {
+            glDeleteSync(retired.fence);
+            glDeleteBuffers(1, &retired.id);
+        }
+        retiredBuffers.clear();
+
         if (bufferID != 0) {
             // Unmap if persistently mapped
             if (mappedPtr) {
@@ -130,7 +257,7 @@ public:
         }
     }
 
-    /// Get buffer ID
+    /// Get buffer ID (changes when a persistent buffer grows)
     GLuint getBufferID() const {
         return bufferID;
     }
@@ -162,7 +289,8 @@ public:
         , usageHint(other.usageHint)
         , capacity(other.capacity)
         , usePersistentMapping(other.usePersistentMapping)
-        , mappedPtr(other.mappedPtr) {
+        , mappedPtr(other.mappedPtr)
+        , retiredBuffers(std::move(other.retiredBuffers)) {
         other.bufferID = 0;
         other.capacity = 0;
         other.mappedPtr = nullptr;
@@ -178,6 +306,7 @@ public:
             capacity = other.capacity;
             usePersistentMapping = other.usePersistentMapping;
             mappedPtr = other.mappedPtr;
+            retiredBuffers = std::move(other.retiredBuffers);
             
             other.bufferID = 0;
             other.capacity = 0;
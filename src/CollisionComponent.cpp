@@ -1,4 +1,5 @@
 #include "CollisionComponent.h"
+#include "TransformComponent.h"
 #include <iostream>
 
 // 静态成员初始化
@@ -12,7 +13,7 @@ CollisionComponent::CollisionComponent(const std::string& name)
     
     // 设置默认值
     s_sharedStorage->setBoundingBox(storageHandle, glm::vec3(-1.0f), glm::vec3(1.0f));
-    s_sharedStorage->setCollisionLayer(storageHandle, 0);
+    s_sharedStorage->setCollisionLayer(storageHandle, 1);
     s_sharedStorage->setCollisionMask(storageHandle, 0xFFFFFFFF);
     s_sharedStorage->setEnabled(storageHandle, true);
 }
@@ -36,6 +37,27 @@ glm::vec3 CollisionComponent::getBoundingBoxMax() const {
     return s_sharedStorage->getBoundingBoxMax(storageHandle);
 }
 
+void CollisionComponent::bindTransform(const std::shared_ptr<TransformComponent>& transform) {
+    s_sharedStorage->bindTransform(storageHandle,
+        transform ? transform->getStorageHandle() : CollisionDataStorage::NO_TRANSFORM);
+}
+
+glm::vec3 CollisionComponent::getWorldBoundingBoxMin() const {
+    return s_sharedStorage->getWorldBoundingBoxMin(storageHandle);
+}
+
+glm::vec3 CollisionComponent::getWorldBoundingBoxMax() const {
+    return s_sharedStorage->getWorldBoundingBoxMax(storageHandle);
+}
+
+void CollisionComponent::setShape(CollisionShape shape) {
+    s_sharedStorage->setShape(storageHandle, shape);
+}
+
+CollisionShape CollisionComponent::getShape() const {
+    return s_sharedStorage->getShape(storageHandle);
+}
+
 void CollisionComponent::setCollisionLayer(uint32_t layer) {
     s_sharedStorage->setCollisionLayer(storageHandle, layer);
 }
@@ -60,6 +82,27 @@ bool CollisionComponent::isEnabled() const {
     return s_sharedStorage->isEnabled(storageHandle);
 }
 
+bool CollisionComponent::isSleeping() const {
+    return s_sharedStorage->isSleeping(storageHandle);
+}
+
+void CollisionComponent::wake() {
+    s_sharedStorage->wake(storageHandle);
+}
+
+void CollisionComponent::setContinuous(bool continuous) {
+    s_sharedStorage->setContinuous(storageHandle, continuous);
+}
+
+bool CollisionComponent::isContinuous() const {
+    return s_sharedStorage->isContinuous(storageHandle);
+}
+
+void CollisionComponent::setOwner(std::shared_ptr<GameEntity> entity) {
+    EntityComponent::setOwner(entity);
+    s_sharedStorage->setOwner(storageHandle, entity);
+}
+
 std::shared_ptr<CollisionDataStorage> CollisionComponent::getSharedStorage() {
     return s_sharedStorage;
 }
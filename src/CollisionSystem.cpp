@@ -0,0 +1,944 @@
+#include "CollisionSystem.h"
+#include "CollisionComponent.h"
+#include "TransformComponent.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+namespace {
+    constexpr size_t WORLD_BOUNDS_GRAIN = 4096;
+    constexpr size_t PAIR_QUERY_GRAIN = 512;
+
+    // Incremental static inserts/removals tolerated before the static tree is rebuilt with SAH
+    constexpr float STATIC_REBUILD_FRACTION = 0.25f;
+}
+
+CollisionSystem::CollisionSystem(const std::string& name)
+    : EntitySystem(name)
+    , staticTree(0.0f) {
+}
+
+CollisionSystem::~CollisionSystem() {
+    shutdown();
+}
+
+void CollisionSystem::initialize() {
+    std::cout << "[CollisionSystem] Initializing static/dynamic AABB tree broadphase..." << std::endl;
+    if (!storage) {
+        storage = CollisionComponent::getSharedStorage();
+    }
+    if (!transformStorage) {
+        transformStorage = TransformComponent::getSharedStorage();
+    }
+    if (!threadPool) {
+        threadPool = std::make_shared<ThreadPool>();
+    }
+    overlapPairs.reserve(1024);
+    initialized = true;
+}
+
+void CollisionSystem::update(float deltaTime) {
+    // Broadphase is stepped manually via step() once transforms are final for the frame
+}
+
+void CollisionSystem::shutdown() {
+    tree.clear();
+    staticTree.clear();
+    proxyIds.clear();
+    proxyInStaticTree.clear();
+    lastBounds.clear();
+    movedThisStep.clear();
+    awakeBodies.clear();
+    awakePositions.clear();
+    sleepIslandIds.clear();
+    sleepingIslands.clear();
+    sweptBodies.clear();
+    continuousHits.clear();
+    retiredSlots.clear();
+    staticChangesSinceBuild = 0;
+    moveBuffer.clear();
+    moveFlags.clear();
+    boundsWork.clear();
+    boundsQueued.clear();
+    overlapPairs.clear();
+    contacts.clear();
+    pairCache.clear();
+    beginPairs.clear();
+    endPairs.clear();
+    sweepOrder.clear();
+    sweepOrderDirty = true;
+    initialized = false;
+}
+
+void CollisionSystem::step(float deltaTime) {
+    if (!initialized || !storage) return;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    stepDeltaTime = deltaTime;
+    updateWorldBounds();
+    syncProxies();
+    findContinuousHits();
+    updatePairCache();
+
+    if (narrowphaseEnabled) {
+        narrowphase.run(*storage, transformStorage.get(), pairCache.getPairs(), contacts, threadPool.get());
+    } else {
+        contacts.clear();
+    }
+
+    if (sleepingEnabled) {
+        updateSleep(deltaTime);
+    }
+    releaseRetiredSlots();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    lastStepTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void CollisionSystem::rebuildTree() {
+    if (!storage) return;
+
+    updateWorldBounds();
+    syncProxies();
+    tree.rebuildSAH();
+    staticTree.rebuildSAH();
+    staticChangesSinceBuild = 0;
+    std::cout << "[CollisionSystem] SAH rebuild: " << tree.getProxyCount() << " dynamic proxies (height "
+              << tree.getHeight() << ", area ratio " << tree.getAreaRatio() << "), "
+              << staticTree.getProxyCount() << " static proxies (height " << staticTree.getHeight()
+              << ", area ratio " << staticTree.getAreaRatio() << ")" << std::endl;
+}
+
+void CollisionSystem::updateWorldBounds() {
+    lastWorldBoundsUpdateCount = 0;
+    const size_t count = storage->getCount();
+    if (!transformStorage || count == 0) return;
+
+    // Setters only flag rows dirty - bring the world matrices up to date first, so this
+    // frame's transform changes reach the change log (and the bounds) before the broadphase
+    transformStorage->updateMovableWorldMatrices();
+
+    if (boundsQueued.size() < count) {
+        boundsQueued.resize(count, 0);
+    }
+
+    // Work list: slots bound to a transform whose world matrix or mobility changed, plus
+    // slots whose local bounds or binding changed - untouched slots are never visited
+    boundsWork.clear();
+    auto queue = [&](uint32_t index) {
+        if (!boundsQueued[index]) {
+            boundsQueued[index] = 1;
+            boundsWork.push_back(index);
+        }
+    };
+    for (TransformDataStorage::HandleID handle : transformStorage->getWorldChanges()) {
+        storage->forEachSlotOfTransform(handle, queue);
+    }
+    transformStorage->clearWorldChanges();
+    for (uint32_t index : storage->getStaleIndices()) {
+        queue(index);
+    }
+    storage->clearStale();
+    if (boundsWork.empty()) return;
+
+    const auto& handles = storage->getAllTransformHandles();
+    const auto& localMins = storage->getAllLocalMins();
+    const auto& localMaxs = storage->getAllLocalMaxs();
+    auto& seenVersions = storage->getAllSeenWorldVersions();
+    auto& stale = storage->getAllBoundsStale();
+    auto& slotMobility = storage->getAllMobility();
+
+    const auto& matrices = transformStorage->getAllWorldMatrices();
+    const auto& versions = transformStorage->getAllWorldVersions();
+    const auto& mobility = transformStorage->getAllMobility();
+
+    const size_t workCount = boundsWork.size();
+    size_t chunkCount = ThreadPool::getChunkCount(workCount, WORLD_BOUNDS_GRAIN);
+    if (chunkUpdatedSlots.size() < chunkCount) {
+        chunkUpdatedSlots.resize(chunkCount);
+    }
+    for (auto& chunk : chunkUpdatedSlots) {
+        chunk.clear();
+    }
+
+    threadPool->parallelFor(workCount, WORLD_BOUNDS_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+        std::vector<uint32_t>& updated = chunkUpdatedSlots[begin / WORLD_BOUNDS_GRAIN];
+
+        for (size_t w = begin; w < end; ++w) {
+            const uint32_t i = boundsWork[w];
+            boundsQueued[i] = 0;
+
+            // Unbound (or the transform was destroyed): world bounds = local bounds
+            if (!transformStorage->isValid(handles[i])) {
+                storage->writeWorldBounds(i, localMins[i], localMaxs[i]);
+                stale[i] = 0;
+                updated.push_back(i);
+                continue;
+            }
+            uint32_t row = transformStorage->getRow(handles[i]);
+            // Static transforms are only recomputed when the slot itself or its mobility changed
+            bool mobilityChanged = slotMobility[i] != mobility[row];
+            if (!stale[i] && !mobilityChanged &&
+                (mobility[row] == 0 || versions[row] == seenVersions[i])) continue;
+
+            // Transform center, extents through |M| (Arvo): tight for the OBB's enclosing box
+            const glm::mat4& m = matrices[row];
+            glm::vec3 center = (localMins[i] + localMaxs[i]) * 0.5f;
+            glm::vec3 extents = (localMaxs[i] - localMins[i]) * 0.5f;
+            glm::vec3 worldCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+            glm::vec3 worldExtents = glm::abs(glm::vec3(m[0])) * extents.x +
+                                     glm::abs(glm::vec3(m[1])) * extents.y +
+                                     glm::abs(glm::vec3(m[2])) * extents.z;
+
+            storage->writeWorldBounds(i, worldCenter - worldExtents, worldCenter + worldExtents);
+            seenVersions[i] = versions[row];
+            stale[i] = 0;
+            slotMobility[i] = mobility[row];
+            updated.push_back(i);
+        }
+    });
+
+    // The dirty list is not thread-safe - feed it in chunk (work list) order
+    for (size_t c = 0; c < chunkCount; ++c) {
+        for (uint32_t index : chunkUpdatedSlots[c]) {
+            storage->markDirty(index);
+        }
+        lastWorldBoundsUpdateCount += chunkUpdatedSlots[c].size();
+    }
+}
+
+void CollisionSystem::syncProxies() {
+    const auto& enabled = storage->getAllEnabledFlags();
+    const auto& mobility = storage->getAllMobility();
+    const auto& continuous = storage->getAllContinuousFlags();
+    auto& sleepFlags = storage->getAllSleepFlags();
+    auto& sleepTimers = storage->getAllSleepTimers();
+
+    const size_t count = storage->getCount();
+    if (proxyIds.size() < count) {
+        proxyIds.resize(count, DynamicAABBTree::NULL_NODE);
+        proxyInStaticTree.resize(count, 0);
+        lastBounds.resize(count);
+        movedThisStep.resize(count, 0);
+        awakePositions.resize(count, NOT_AWAKE);
+        sleepIslandIds.resize(count, NO_ISLAND);
+        sleepingIslands.resize(count);
+        moveFlags.resize(count, 0);
+    }
+
+    bool bulkLoadStatic = staticTree.getProxyCount() == 0;
+    size_t staticChanges = 0;
+    const float motionLimit = sleepLinearThreshold * stepDeltaTime;
+    sweptBodies.clear();
+
+    // Only slots touched since the last step are visited - untouched leaves are never refit.
+    // Indexed loop: waking an island marks its members dirty, they are synced in this pass
+    const auto& dirtyIndices = storage->getDirtyIndices();
+    for (size_t d = 0; d < dirtyIndices.size(); ++d) {
+        uint32_t index = dirtyIndices[d];
+        bufferMove(index);
+        int32_t& proxyId = proxyIds[index];
+        AABB bounds = storage->getBounds(index);
+
+        // Bounds moving faster than the sleep threshold keep (or make) the body awake
+        if (enabled[index] && mobility[index] != 0 && proxyId != DynamicAABBTree::NULL_NODE) {
+            const AABB& last = lastBounds[index];
+            glm::vec3 motion = glm::max(glm::abs(bounds.min - last.min), glm::abs(bounds.max - last.max));
+            if (std::max(motion.x, std::max(motion.y, motion.z)) > motionLimit) {
+                movedThisStep[index] = 1;
+                if (sleepFlags[index]) {
+                    wakeIsland(index);
+                }
+                sleepTimers[index] = 0.0f;
+            }
+            // Start of the sweep - only bodies that were already in a tree have one
+            if (continuous[index]) {
+                sweptBodies.push_back({index, last});
+            }
+        }
+        lastBounds[index] = bounds;
+
+        // A body woken through the storage (wake()) takes its whole stored island with it
+        if (!sleepFlags[index] && sleepIslandIds[index] != NO_ISLAND) {
+            wakeIsland(index);
+        }
+
+        // Sleeping bodies are parked in the static tree: never refit, and only paired with awake bodies
+        bool wantStatic = mobility[index] == 0 || sleepFlags[index] != 0;
+
+        // Remove when disabled, and whenever a static leaf changes or the slot migrates between trees
+        if (proxyId != DynamicAABBTree::NULL_NODE &&
+            (!enabled[index] || proxyInStaticTree[index] || wantStatic != (proxyInStaticTree[index] != 0))) {
+            if (proxyInStaticTree[index]) {
+                staticTree.destroyProxy(proxyId);
+                ++staticChanges;
+            } else {
+                tree.destroyProxy(proxyId);
+                removeAwakeBody(index);
+                sweepOrderDirty = true;
+            }
+            proxyId = DynamicAABBTree::NULL_NODE;
+        }
+        if (!enabled[index]) continue;
+
+        if (wantStatic) {
+            // Static leaves are kept tight (zero margin) - reinserted instead of fattened
+            proxyId = staticTree.createProxy(bounds, index);
+            proxyInStaticTree[index] = 1;
+            ++staticChanges;
+        } else if (proxyId == DynamicAABBTree::NULL_NODE) {
+            proxyId = tree.createProxy(bounds, index);
+            proxyInStaticTree[index] = 0;
+            addAwakeBody(index);
+            sweepOrderDirty = true;
+        } else {
+            tree.moveProxy(proxyId, bounds);
+        }
+    }
+    storage->clearDirty();
+
+    // Removed slots lost their proxy above (or had none while disabled); they are handed
+    // back for reuse once the pair update has pruned their pairs
+    const auto& removed = storage->getRemovedSlots();
+    retiredSlots.insert(retiredSlots.end(), removed.begin(), removed.end());
+    storage->clearRemovedSlots();
+
+    // Static tree is built once with SAH (first load), then only rebuilt after enough
+    // migrations have degraded the incrementally inserted leaves
+    staticChangesSinceBuild += staticChanges;
+    if (staticChanges > 0 &&
+        (bulkLoadStatic ||
+         staticChangesSinceBuild > staticTree.getProxyCount() * STATIC_REBUILD_FRACTION)) {
+        staticTree.rebuildSAH();
+        staticChangesSinceBuild = 0;
+    }
+}
+
+void CollisionSystem::bufferMove(uint32_t index) {
+    if (!moveFlags[index]) {
+        moveFlags[index] = 1;
+        moveBuffer.push_back(index);
+    }
+}
+
+bool CollisionSystem::isPairActive(uint32_t a, uint32_t b) const {
+    if (proxyIds[a] == DynamicAABBTree::NULL_NODE || proxyIds[b] == DynamicAABBTree::NULL_NODE) return false;
+    if (proxyInStaticTree[a] && proxyInStaticTree[b]) {
+        // Neither side awake: a pair with a sleeping body stays frozen until its island wakes
+        const auto& sleepFlags = storage->getAllSleepFlags();
+        return (sleepFlags[a] || sleepFlags[b]) && storage->canCollide(a, b);
+    }
+    return storage->canCollide(a, b) && storage->getBounds(a).overlaps(storage->getBounds(b));
+}
+
+void CollisionSystem::updatePairCache() {
+    if (broadphaseType == BroadphaseType::DynamicTree) {
+        updateMovedPairs();
+    } else {
+        findOverlapPairs(broadphaseType);
+        // Frozen pairs are never regenerated (both proxies sit in the static tree) - carry them over
+        for (const CollisionPair& pair : pairCache.getPairs()) {
+            if (proxyInStaticTree[pair.a] && proxyInStaticTree[pair.b] && isPairActive(pair.a, pair.b)) {
+                overlapPairs.push_back(pair);
+            }
+        }
+        pairCache.update(overlapPairs, beginPairs, endPairs);
+        for (uint32_t index : moveBuffer) {
+            moveFlags[index] = 0;
+        }
+        moveBuffer.clear();
+    }
+
+    // Typed dispatch by reference - the batches stay in our vectors, nothing is allocated
+    auto events = eventSystem.lock();
+    if (!events) return;
+    if (!beginPairs.empty()) {
+        events->dispatch(CollisionBeginEvent{beginPairs});
+    }
+    if (!endPairs.empty()) {
+        events->dispatch(CollisionEndEvent{endPairs});
+    }
+}
+
+void CollisionSystem::updateMovedPairs() {
+    beginPairs.clear();
+    endPairs.clear();
+
+    // Every input of isPairActive() (bounds, tree membership, enabled, layer/mask) only
+    // changes through the dirty list, so pairs between two untouched proxies keep their state
+
+    // 1. Cached pairs of moved proxies that stopped overlapping
+    for (uint32_t a : moveBuffer) {
+        pairCache.prunePairs(a, [&](uint32_t b) { return isPairActive(a, b); }, endPairs);
+    }
+
+    // 2. Query moved proxies: awake ones against both trees, static/sleeping ones against
+    //    the dynamic tree only. Tree queries are read-only - split across the pool.
+    const size_t count = moveBuffer.size();
+    size_t chunkCount = ThreadPool::getChunkCount(count, PAIR_QUERY_GRAIN);
+    if (chunkPairs.size() < chunkCount) {
+        chunkPairs.resize(chunkCount);
+    }
+    for (auto& chunk : chunkPairs) {
+        chunk.clear();
+    }
+
+    const auto& layers = storage->getAllCollisionLayers();
+    const auto& masks = storage->getAllCollisionMasks();
+
+    threadPool->parallelFor(count, PAIR_QUERY_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+        std::vector<CollisionPair>& local = chunkPairs[begin / PAIR_QUERY_GRAIN];
+
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t a = moveBuffer[i];
+            if (proxyIds[a] == DynamicAABBTree::NULL_NODE) continue;
+            AABB bounds = storage->getBounds(a);
+            auto report = [&](uint32_t b) {
+                local.push_back(a < b ? CollisionPair{a, b} : CollisionPair{b, a});
+            };
+
+            // Leaves are collected 8 at a time; the SIMD kernel confirms the tight bounds
+            // (dynamic leaves are fat) and applies the layer/mask filter
+            auto leavesOf = [&](const DynamicAABBTree& index) {
+                return [&](auto&& push) {
+                    index.queryAABB(bounds, [&](int32_t proxyId) {
+                        uint32_t b = index.getUserData(proxyId);
+                        if (b != a) push(b);
+                        return true;
+                    });
+                };
+            };
+            storage->batchOverlaps(bounds, layers[a], masks[a], leavesOf(tree), report);
+            if (!proxyInStaticTree[a]) {
+                storage->batchOverlaps(bounds, layers[a], masks[a], leavesOf(staticTree), report);
+            }
+        }
+    });
+
+    // 3. Insert in chunk order; a pair between two moved proxies is found twice, added once
+    for (size_t c = 0; c < chunkCount; ++c) {
+        for (const CollisionPair& pair : chunkPairs[c]) {
+            if (pairCache.add(pair.a, pair.b)) {
+                beginPairs.push_back(pair);
+            }
+        }
+    }
+
+    for (uint32_t index : moveBuffer) {
+        moveFlags[index] = 0;
+    }
+    moveBuffer.clear();
+
+    PairCache::sortPairs(beginPairs);
+    PairCache::sortPairs(endPairs);
+}
+
+void CollisionSystem::releaseRetiredSlots() {
+    for (uint32_t index : retiredSlots) {
+        // A removed sleeper leaves a gap in its resting island - the rest of it wakes up
+        if (sleepIslandIds[index] != NO_ISLAND) {
+            wakeIsland(index);
+        }
+        movedThisStep[index] = 0;
+        storage->releaseSlot(index);
+    }
+    retiredSlots.clear();
+}
+
+void CollisionSystem::addAwakeBody(uint32_t index) {
+    awakePositions[index] = static_cast<uint32_t>(awakeBodies.size());
+    awakeBodies.push_back(index);
+}
+
+void CollisionSystem::removeAwakeBody(uint32_t index) {
+    uint32_t position = awakePositions[index];
+    if (position == NOT_AWAKE) return;
+    uint32_t last = awakeBodies.back();
+    awakeBodies[position] = last;
+    awakePositions[last] = position;
+    awakeBodies.pop_back();
+    awakePositions[index] = NOT_AWAKE;
+}
+
+uint32_t CollisionSystem::findIsland(uint32_t index) {
+    // Path halving
+    while (islandParents[index] != index) {
+        islandParents[index] = islandParents[islandParents[index]];
+        index = islandParents[index];
+    }
+    return index;
+}
+
+void CollisionSystem::updateSleep(float deltaTime) {
+    auto& sleepFlags = storage->getAllSleepFlags();
+    auto& sleepTimers = storage->getAllSleepTimers();
+    const auto& mobility = storage->getAllMobility();
+    const size_t count = storage->getCount();
+
+    if (islandParents.size() < count) {
+        islandParents.resize(count);
+        islandStamps.resize(count, 0);
+        islandMinTimers.resize(count);
+        islandMoved.resize(count);
+    }
+    ++islandFrame;
+
+    auto unite = [&](uint32_t a, uint32_t b) {
+        uint32_t rootA = findIsland(a);
+        uint32_t rootB = findIsland(b);
+        if (rootA != rootB) {
+            // Lower slot becomes the root so island ids are deterministic
+            if (rootA < rootB) islandParents[rootB] = rootA; else islandParents[rootA] = rootB;
+        }
+    };
+
+    // Participants: awake bodies plus sleeping bodies they touch (union-find state is
+    // reset lazily by stamp, so the cost follows the active set, not the slot count).
+    // A touched sleeper brings in the id of its stored island, which stands for the rest of it.
+    islandMembers.clear();
+    auto join = [&](uint32_t index) {
+        if (islandStamps[index] == islandFrame) return false;
+        islandStamps[index] = islandFrame;
+        islandParents[index] = index;
+        islandMembers.push_back(index);
+        return true;
+    };
+    auto touch = [&](uint32_t index) {
+        if (!join(index)) return;
+        uint32_t island = sleepIslandIds[index];
+        if (island != NO_ISLAND && island != index) {
+            join(island);
+            unite(index, island);
+        }
+    };
+
+    for (uint32_t index : awakeBodies) {
+        if (!movedThisStep[index]) {
+            sleepTimers[index] += deltaTime;
+        }
+        touch(index);
+    }
+
+    // Contacts between movable bodies link islands; static colliders never do. Frozen
+    // contacts between two sleepers are already recorded in their stored island.
+    auto link = [&](uint32_t a, uint32_t b) {
+        if (mobility[a] == 0 || mobility[b] == 0) return;
+        if (sleepFlags[a] && sleepFlags[b]) return;
+        touch(a);
+        touch(b);
+        unite(a, b);
+    };
+    if (narrowphaseEnabled) {
+        for (const Contact& contact : contacts) link(contact.a, contact.b);
+    } else {
+        for (const CollisionPair& pair : pairCache.getPairs()) link(pair.a, pair.b);
+    }
+
+    // Island state: shortest rest time, and whether any member moved this step
+    for (uint32_t index : islandMembers) {
+        uint32_t root = findIsland(index);
+        if (root == index) {
+            islandMinTimers[root] = sleepTimers[index];
+            islandMoved[root] = movedThisStep[index];
+        }
+    }
+    lastIslandCount = 0;
+    for (uint32_t index : islandMembers) {
+        uint32_t root = findIsland(index);
+        if (root == index) {
+            ++lastIslandCount;
+            continue;
+        }
+        islandMinTimers[root] = std::min(islandMinTimers[root], sleepTimers[index]);
+        islandMoved[root] |= movedThisStep[index];
+    }
+
+    // Whole islands sleep once every member has rested long enough and are stored under
+    // their root, absorbing the sleeping islands they touch; an island with a moving member
+    // wakes every stored island it reached. Transitions migrate on the next sync.
+    for (uint32_t index : islandMembers) {
+        uint32_t root = findIsland(index);
+        if (islandMinTimers[root] >= timeToSleep) {
+            uint32_t island = sleepIslandIds[index];
+            if (island == root) continue;
+            if (island != NO_ISLAND) {
+                for (uint32_t member : sleepingIslands[island]) {
+                    sleepIslandIds[member] = root;
+                }
+                sleepingIslands[root].insert(sleepingIslands[root].end(),
+                                             sleepingIslands[island].begin(), sleepingIslands[island].end());
+                sleepingIslands[island].clear();
+            } else {
+                sleepIslandIds[index] = root;
+                sleepingIslands[root].push_back(index);
+            }
+            if (!sleepFlags[index]) {
+                sleepFlags[index] = 1;
+                storage->markDirty(index);
+            }
+        } else if (islandMoved[root] && sleepFlags[index]) {
+            wakeIsland(index);
+        }
+    }
+
+    for (uint32_t index : awakeBodies) {
+        movedThisStep[index] = 0;
+    }
+}
+
+void CollisionSystem::wakeIsland(uint32_t index) {
+    auto& sleepFlags = storage->getAllSleepFlags();
+    auto& sleepTimers = storage->getAllSleepTimers();
+    auto wake = [&](uint32_t slot) {
+        sleepIslandIds[slot] = NO_ISLAND;
+        sleepTimers[slot] = 0.0f;
+        if (sleepFlags[slot]) {
+            sleepFlags[slot] = 0;
+            storage->markDirty(slot);
+        }
+    };
+
+    uint32_t island = sleepIslandIds[index];
+    wake(index);
+    if (island == NO_ISLAND) return;
+    for (uint32_t member : sleepingIslands[island]) {
+        wake(member);
+    }
+    sleepingIslands[island].clear();
+}
+
+void CollisionSystem::setSleepingEnabled(bool enabled) {
+    sleepingEnabled = enabled;
+    if (enabled || !storage) return;
+
+    // Wake everything so parked bodies return to the dynamic tree
+    auto& sleepFlags = storage->getAllSleepFlags();
+    auto& sleepTimers = storage->getAllSleepTimers();
+    for (size_t i = 0; i < storage->getCount(); ++i) {
+        sleepTimers[i] = 0.0f;
+        if (sleepFlags[i]) {
+            sleepFlags[i] = 0;
+            storage->markDirty(i);
+        }
+    }
+    std::fill(sleepIslandIds.begin(), sleepIslandIds.end(), NO_ISLAND);
+    for (auto& island : sleepingIslands) {
+        island.clear();
+    }
+}
+
+void CollisionSystem::findOverlapPairs(BroadphaseType type) {
+    // Dynamic-vs-dynamic with the selected algorithm, then dynamic-vs-static;
+    // static-vs-static pairs are never generated
+    switch (type) {
+        case BroadphaseType::DynamicTree:   findPairsTree(); break;
+        case BroadphaseType::UniformGrid:   findPairsGrid(); break;
+        case BroadphaseType::SweepAndPrune: findPairsSweepAndPrune(); break;
+    }
+    findDynamicStaticPairs();
+}
+
+void CollisionSystem::findDynamicStaticPairs() {
+    if (staticTree.getProxyCount() == 0 || awakeBodies.empty()) return;
+
+    // Awake bodies are exactly the dynamic tree's leaves
+    const size_t count = awakeBodies.size();
+    size_t chunkCount = ThreadPool::getChunkCount(count, PAIR_QUERY_GRAIN);
+    if (chunkPairs.size() < chunkCount) {
+        chunkPairs.resize(chunkCount);
+    }
+    for (auto& chunk : chunkPairs) {
+        chunk.clear();
+    }
+
+    const auto& layers = storage->getAllCollisionLayers();
+    const auto& masks = storage->getAllCollisionMasks();
+
+    // Tree queries are read-only - awake bodies are split across the pool
+    threadPool->parallelFor(count, PAIR_QUERY_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+        std::vector<CollisionPair>& local = chunkPairs[begin / PAIR_QUERY_GRAIN];
+
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t a = awakeBodies[i];
+            AABB bounds = storage->getBounds(a);
+            // Static leaves, 8 per kernel call (layer/mask filter)
+            storage->batchOverlaps(bounds, layers[a], masks[a],
+                [&](auto&& push) {
+                    staticTree.queryAABB(bounds, [&](int32_t proxyId) {
+                        push(staticTree.getUserData(proxyId));
+                        return true;
+                    });
+                },
+                [&](uint32_t b) {
+                    local.push_back(a < b ? CollisionPair{a, b} : CollisionPair{b, a});
+                });
+        }
+    });
+
+    for (size_t c = 0; c < chunkCount; ++c) {
+        overlapPairs.insert(overlapPairs.end(), chunkPairs[c].begin(), chunkPairs[c].end());
+    }
+}
+
+void CollisionSystem::findContinuousHits() {
+    continuousHits.clear();
+
+    for (const SweptBody& body : sweptBodies) {
+        const uint32_t a = body.index;
+        AABB end = storage->getBounds(a);
+        glm::vec3 delta = end.center() - body.start.center();
+        AABB swept = AABB::merge(body.start, end);
+
+        // Swept box through both trees, then an exact swept-AABB test per candidate
+        auto sweepAgainst = [&](const DynamicAABBTree& target) {
+            target.queryAABB(swept, [&](int32_t proxyId) {
+                uint32_t b = target.getUserData(proxyId);
+                if (b == a || !storage->canCollide(a, b)) return true;
+
+                ContinuousHit hit;
+                if (body.start.sweep(delta, storage->getBounds(b), hit.toi, hit.normal)) {
+                    hit.index = a;
+                    hit.other = b;
+                    hit.position = body.start.center() + delta * hit.toi;
+                    continuousHits.push_back(hit);
+                }
+                return true;
+            });
+        };
+        sweepAgainst(staticTree);
+        sweepAgainst(tree);
+    }
+
+    std::sort(continuousHits.begin(), continuousHits.end(), [](const ContinuousHit& x, const ContinuousHit& y) {
+        if (x.index != y.index) return x.index < y.index;
+        if (x.toi != y.toi) return x.toi < y.toi;
+        return x.other < y.other;
+    });
+}
+
+void CollisionSystem::findPairsTree() {
+    overlapPairs.clear();
+
+    tree.queryAllPairs([&](int32_t proxyA, int32_t proxyB) {
+        uint32_t a = tree.getUserData(proxyA);
+        uint32_t b = tree.getUserData(proxyB);
+
+        // Fat boxes overlap - confirm with the tight bounds and the layer filter
+        if (!storage->canCollide(a, b)) return;
+        if (!storage->getBounds(a).overlaps(storage->getBounds(b))) return;
+
+        if (a > b) std::swap(a, b);
+        overlapPairs.push_back({a, b});
+    });
+}
+
+void CollisionSystem::findPairsGrid() {
+    grid.build(*storage, threadPool.get());
+    grid.findPairs(*storage, overlapPairs, threadPool.get());
+}
+
+void CollisionSystem::findPairsSweepAndPrune() {
+    overlapPairs.clear();
+
+    const auto& minX = storage->getMinX();
+    const auto& enabled = storage->getAllEnabledFlags();
+    const auto& mobility = storage->getAllMobility();
+    const auto& sleeping = storage->getAllSleepFlags();
+    const auto& layers = storage->getAllCollisionLayers();
+    const auto& masks = storage->getAllCollisionMasks();
+
+    if (sweepOrderDirty) {
+        sweepOrder.clear();
+        for (size_t i = 0; i < storage->getCount(); ++i) {
+            if (enabled[i] && mobility[i] != 0 && !sleeping[i]) sweepOrder.push_back(static_cast<uint32_t>(i));
+        }
+        std::sort(sweepOrder.begin(), sweepOrder.end(), [&](uint32_t a, uint32_t b) {
+            return minX[a] < minX[b];
+        });
+        sweepOrderDirty = false;
+    } else {
+        // Insertion sort - nearly sorted from last frame, so close to O(n)
+        for (size_t i = 1; i < sweepOrder.size(); ++i) {
+            uint32_t value = sweepOrder[i];
+            float key = minX[value];
+            size_t j = i;
+            while (j > 0 && minX[sweepOrder[j - 1]] > key) {
+                sweepOrder[j] = sweepOrder[j - 1];
+                --j;
+            }
+            sweepOrder[j] = value;
+        }
+    }
+
+    // Candidates following a in sweep order are tested 8 at a time; the kernel's
+    // min.x <= max.x test already rejects boxes past the sweep line inside a block
+    const size_t count = sweepOrder.size();
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t a = sweepOrder[i];
+        AABB box = storage->getBounds(a);
+        for (size_t j = i + 1; j < count; j += CollisionDataStorage::LANE_WIDTH) {
+            size_t blockSize = std::min(CollisionDataStorage::LANE_WIDTH, count - j);
+            uint32_t bits = storage->overlapMask8(box, layers[a], masks[a], &sweepOrder[j], blockSize);
+            while (bits != 0) {
+                uint32_t b = sweepOrder[j + CollisionDataStorage::countTrailingZeros(bits)];
+                bits &= bits - 1;
+                overlapPairs.push_back(a < b ? CollisionPair{a, b} : CollisionPair{b, a});
+            }
+            if (minX[sweepOrder[j + blockSize - 1]] > box.max.x) break;
+        }
+    }
+}
+
+size_t CollisionSystem::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                                uint32_t layerMask, QueryMode mode, std::vector<RaycastHit>& outHits) const {
+    outHits.clear();
+    if (!storage) return 0;
+
+    float length = glm::length(direction);
+    if (length <= 0.0f || maxDistance < 0.0f) return 0;
+    glm::vec3 dir = direction / length;
+
+    const auto& layers = storage->getAllCollisionLayers();
+    RaycastHit closest;
+    bool hasClosest = false;
+
+    auto castTree = [&](const DynamicAABBTree& index) {
+        // The second tree starts clipped to the closest hit of the first
+        float maxT = hasClosest ? closest.distance : maxDistance;
+        index.raycast(origin, dir, maxT, [&](int32_t proxyId, float clipT) -> float {
+            uint32_t slot = index.getUserData(proxyId);
+            if ((layers[slot] & layerMask) == 0) return -1.0f;
+
+            // Fat box was hit - test the tight bounds
+            float distance = 0.0f;
+            if (!storage->getBounds(slot).intersectRay(origin, dir, clipT, distance)) return -1.0f;
+
+            RaycastHit hit{slot, distance, origin + dir * distance};
+            if (mode == QueryMode::All) {
+                outHits.push_back(hit);
+                return -1.0f;
+            }
+
+            // Ties (e.g. coplanar quads) resolve to the lowest slot so picking is stable
+            if (!hasClosest || distance < closest.distance ||
+                (distance == closest.distance && slot < closest.index)) {
+                closest = hit;
+                hasClosest = true;
+            }
+            // Clip the ray; keep a zero distance from terminating the traversal before ties are seen
+            return std::max(distance, std::numeric_limits<float>::min());
+        });
+    };
+    castTree(tree);
+    castTree(staticTree);
+
+    if (mode == QueryMode::Closest) {
+        if (hasClosest) outHits.push_back(closest);
+    } else {
+        std::sort(outHits.begin(), outHits.end(), [](const RaycastHit& a, const RaycastHit& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+        });
+    }
+    return outHits.size();
+}
+
+size_t CollisionSystem::pointQuery(const glm::vec3& point, uint32_t layerMask, QueryMode mode,
+                                   std::vector<uint32_t>& outIndices) const {
+    outIndices.clear();
+    if (!storage) return 0;
+
+    const auto& layers = storage->getAllCollisionLayers();
+    float closestDistance2 = std::numeric_limits<float>::max();
+
+    auto queryTree = [&](const DynamicAABBTree& index) {
+        index.queryPoint(point, [&](int32_t proxyId) {
+            uint32_t slot = index.getUserData(proxyId);
+            if ((layers[slot] & layerMask) == 0) return true;
+
+            AABB bounds = storage->getBounds(slot);
+            if (!bounds.contains(point)) return true;
+
+            if (mode == QueryMode::All) {
+                outIndices.push_back(slot);
+                return true;
+            }
+
+            glm::vec3 offset = bounds.center() - point;
+            float distance2 = glm::dot(offset, offset);
+            if (outIndices.empty() || distance2 < closestDistance2 ||
+                (distance2 == closestDistance2 && slot < outIndices[0])) {
+                outIndices.assign(1, slot);
+                closestDistance2 = distance2;
+            }
+            return true;
+        });
+    };
+    queryTree(tree);
+    queryTree(staticTree);
+
+    std::sort(outIndices.begin(), outIndices.end());
+    return outIndices.size();
+}
+
+size_t CollisionSystem::queryAABB(const AABB& box, uint32_t layerMask, std::vector<uint32_t>& outIndices) const {
+    outIndices.clear();
+    if (!storage) return 0;
+
+    const auto& layers = storage->getAllCollisionLayers();
+    auto queryTree = [&](const DynamicAABBTree& index) {
+        index.queryAABB(box, [&](int32_t proxyId) {
+            uint32_t slot = index.getUserData(proxyId);
+            if ((layers[slot] & layerMask) != 0 && storage->getBounds(slot).overlaps(box)) {
+                outIndices.push_back(slot);
+            }
+            return true;
+        });
+    };
+    queryTree(tree);
+    queryTree(staticTree);
+
+    std::sort(outIndices.begin(), outIndices.end());
+    return outIndices.size();
+}
+
+void CollisionSystem::benchmarkBroadphases(int iterations) {
+    if (!initialized || !storage || iterations <= 0) return;
+
+    updateWorldBounds();
+    syncProxies();
+
+    struct Candidate {
+        BroadphaseType type;
+        const char* name;
+    };
+    const Candidate candidates[] = {
+        {BroadphaseType::DynamicTree, "Dynamic AABB tree"},
+        {BroadphaseType::UniformGrid, "Uniform grid (2D hash)"},
+        {BroadphaseType::SweepAndPrune, "Sweep-and-prune"},
+    };
+
+    std::cout << "[CollisionSystem] Broadphase benchmark: " << storage->getCount() << " colliders, "
+              << iterations << " iterations, " << threadPool->getThreadCount() << " threads" << std::endl;
+
+    for (const auto& candidate : candidates) {
+        // Warm-up pass builds persistent state (sweep order, grid buffers)
+        findOverlapPairs(candidate.type);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            findOverlapPairs(candidate.type);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double avgMs = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+
+        std::cout << "  - " << candidate.name << ": " << avgMs << " ms/frame, "
+                  << overlapPairs.size() << " pairs";
+        if (candidate.type == BroadphaseType::UniformGrid) {
+            std::cout << " (cell size " << grid.getCellSize() << ", "
+                      << grid.getEntryCount() << " cell entries)";
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,446 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+DynamicAABBTree::DynamicAABBTree(float fatMargin)
+    : fatMargin(fatMargin) {
+}
+
+// === Node pool ===
+
+int32_t DynamicAABBTree::allocateNode() {
+    if (freeList == NULL_NODE) {
+        // Grow the pool geometrically and thread the new nodes onto the free list
+        size_t oldCapacity = nodes.size();
+        size_t newCapacity = oldCapacity == 0 ? 16 : oldCapacity * 2;
+        nodes.resize(newCapacity);
+        for (size_t i = oldCapacity; i < newCapacity - 1; ++i) {
+            nodes[i].parent = static_cast<int32_t>(i + 1);
+            nodes[i].height = -1;
+        }
+        nodes[newCapacity - 1].parent = NULL_NODE;
+        nodes[newCapacity - 1].height = -1;
+        freeList = static_cast<int32_t>(oldCapacity);
+    }
+
+    int32_t nodeId = freeList;
+    TreeNode& node = nodes[nodeId];
+    freeList = node.parent;
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    node.userData = 0;
+    return nodeId;
+}
+
+void DynamicAABBTree::freeNode(int32_t nodeId) {
+    nodes[nodeId].parent = freeList;
+    nodes[nodeId].height = -1;
+    freeList = nodeId;
+}
+
+// === Proxy interface ===
+
+int32_t DynamicAABBTree::createProxy(const AABB& aabb, uint32_t userData) {
+    int32_t proxyId = allocateNode();
+    TreeNode& node = nodes[proxyId];
+    node.aabb = aabb.fattened(fatMargin);
+    node.userData = userData;
+    node.height = 0;
+
+    insertLeaf(proxyId);
+    ++proxyCount;
+    return proxyId;
+}
+
+void DynamicAABBTree::destroyProxy(int32_t proxyId) {
+    assert(proxyId >= 0 && proxyId < static_cast<int32_t>(nodes.size()));
+    assert(nodes[proxyId].isLeaf());
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --proxyCount;
+}
+
+bool DynamicAABBTree::moveProxy(int32_t proxyId, const AABB& aabb) {
+    assert(nodes[proxyId].isLeaf());
+
+    // Still inside the fat box - nothing to do (the common case)
+    if (nodes[proxyId].aabb.contains(aabb)) {
+        return false;
+    }
+
+    removeLeaf(proxyId);
+    nodes[proxyId].aabb = aabb.fattened(fatMargin);
+    insertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::clear() {
+    for (int32_t i = 0; i < static_cast<int32_t>(nodes.size()); ++i) {
+        if (nodes[i].height >= 0) {
+            freeNode(i);
+        }
+    }
+    root = NULL_NODE;
+    proxyCount = 0;
+}
+
+// === Incremental insertion / removal ===
+
+void DynamicAABBTree::insertLeaf(int32_t leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // Find the best sibling: descend while the cost of pushing the leaf down
+    // a child is lower than pairing it with the current node
+    AABB leafAABB = nodes[leaf].aabb;
+    int32_t index = root;
+    while (!nodes[index].isLeaf()) {
+        const TreeNode& node = nodes[index];
+        int32_t child1 = node.child1;
+        int32_t child2 = node.child2;
+
+        float area = node.aabb.surfaceArea();
+        float combinedArea = AABB::merge(node.aabb, leafAABB).surfaceArea();
+
+        // Cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            const TreeNode& c = nodes[child];
+            float mergedArea = AABB::merge(leafAABB, c.aabb).surfaceArea();
+            if (c.isLeaf()) {
+                return mergedArea + inheritanceCost;
+            }
+            return (mergedArea - c.aabb.surfaceArea()) + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+
+    // Create a new parent (may grow the pool - no node references held here)
+    int32_t newParent = allocateNode();
+    int32_t oldParent = nodes[sibling].parent;
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].aabb = AABB::merge(leafAABB, nodes[sibling].aabb);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+
+    // Walk back up fixing heights and boxes, rotating where unbalanced
+    refitAncestors(nodes[leaf].parent);
+}
+
+void DynamicAABBTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent != NULL_NODE) {
+        // Splice the sibling into the grandparent and drop the parent
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        } else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refitAncestors(grandParent);
+    } else {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+
+    nodes[leaf].parent = NULL_NODE;
+}
+
+void DynamicAABBTree::refitAncestors(int32_t nodeId) {
+    int32_t index = nodeId;
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        TreeNode& node = nodes[index];
+        const TreeNode& child1 = nodes[node.child1];
+        const TreeNode& child2 = nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.aabb = AABB::merge(child1.aabb, child2.aabb);
+
+        index = node.parent;
+    }
+}
+
+// Perform a left or right rotation if node A is imbalanced
+// Returns the new root index of this subtree
+int32_t DynamicAABBTree::balance(int32_t iA) {
+    TreeNode& A = nodes[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    TreeNode& B = nodes[iB];
+    TreeNode& C = nodes[iC];
+
+    int32_t heightDiff = C.height - B.height;
+
+    // Rotate C up
+    if (heightDiff > 1) {
+        int32_t iF = C.child1;
+        int32_t iG = C.child2;
+        TreeNode& F = nodes[iF];
+        TreeNode& G = nodes[iG];
+
+        // Swap A and C
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        // A's old parent should point to C
+        if (C.parent != NULL_NODE) {
+            if (nodes[C.parent].child1 == iA) {
+                nodes[C.parent].child1 = iC;
+            } else {
+                nodes[C.parent].child2 = iC;
+            }
+        } else {
+            root = iC;
+        }
+
+        // Keep the taller grandchild under C
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.aabb = AABB::merge(B.aabb, G.aabb);
+            C.aabb = AABB::merge(A.aabb, F.aabb);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.aabb = AABB::merge(B.aabb, F.aabb);
+            C.aabb = AABB::merge(A.aabb, G.aabb);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (heightDiff < -1) {
+        int32_t iD = B.child1;
+        int32_t iE = B.child2;
+        TreeNode& D = nodes[iD];
+        TreeNode& E = nodes[iE];
+
+        // Swap A and B
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        // A's old parent should point to B
+        if (B.parent != NULL_NODE) {
+            if (nodes[B.parent].child1 == iA) {
+                nodes[B.parent].child1 = iB;
+            } else {
+                nodes[B.parent].child2 = iB;
+            }
+        } else {
+            root = iB;
+        }
+
+        // Keep the taller grandchild under B
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.aabb = AABB::merge(C.aabb, E.aabb);
+            B.aabb = AABB::merge(A.aabb, D.aabb);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.aabb = AABB::merge(C.aabb, D.aabb);
+            B.aabb = AABB::merge(A.aabb, E.aabb);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+// === Full SAH rebuild ===
+
+void DynamicAABBTree::rebuildSAH() {
+    if (proxyCount == 0) return;
+
+    // Collect leaves and release every internal node back to the pool
+    std::vector<int32_t> leaves;
+    leaves.reserve(proxyCount);
+    for (int32_t i = 0; i < static_cast<int32_t>(nodes.size()); ++i) {
+        if (nodes[i].height < 0) continue;
+        if (nodes[i].isLeaf()) {
+            nodes[i].parent = NULL_NODE;
+            leaves.push_back(i);
+        } else {
+            freeNode(i);
+        }
+    }
+
+    root = buildSAHRange(leaves.data(), static_cast<int32_t>(leaves.size()));
+    nodes[root].parent = NULL_NODE;
+}
+
+int32_t DynamicAABBTree::buildSAHRange(int32_t* leaves, int32_t count) {
+    if (count == 1) {
+        return leaves[0];
+    }
+
+    // Bounds of the leaf centroids pick the split axis
+    glm::vec3 centroidMin = nodes[leaves[0]].aabb.center();
+    glm::vec3 centroidMax = centroidMin;
+    for (int32_t i = 1; i < count; ++i) {
+        glm::vec3 c = nodes[leaves[i]].aabb.center();
+        centroidMin = glm::min(centroidMin, c);
+        centroidMax = glm::max(centroidMax, c);
+    }
+    glm::vec3 centroidExtent = centroidMax - centroidMin;
+    int axis = 0;
+    if (centroidExtent.y > centroidExtent[axis]) axis = 1;
+    if (centroidExtent.z > centroidExtent[axis]) axis = 2;
+
+    int32_t splitCount = count / 2;
+    if (centroidExtent[axis] > 0.0f) {
+        // Binned SAH: bucket centroids, then sweep split planes between buckets
+        constexpr int BIN_COUNT = 16;
+        struct Bin {
+            AABB bounds;
+            int32_t count = 0;
+        };
+        Bin bins[BIN_COUNT];
+
+        float binScale = BIN_COUNT / centroidExtent[axis];
+        auto binIndex = [&](int32_t leaf) {
+            int b = static_cast<int>((nodes[leaf].aabb.center()[axis] - centroidMin[axis]) * binScale);
+            return std::min(b, BIN_COUNT - 1);
+        };
+
+        for (int32_t i = 0; i < count; ++i) {
+            Bin& bin = bins[binIndex(leaves[i])];
+            const AABB& box = nodes[leaves[i]].aabb;
+            bin.bounds = bin.count == 0 ? box : AABB::merge(bin.bounds, box);
+            ++bin.count;
+        }
+
+        // Right-to-left sweep gives the cost of every right partition
+        float rightCost[BIN_COUNT] = {};
+        AABB accum;
+        int32_t accumCount = 0;
+        for (int b = BIN_COUNT - 1; b > 0; --b) {
+            if (bins[b].count > 0) {
+                accum = accumCount == 0 ? bins[b].bounds : AABB::merge(accum, bins[b].bounds);
+                accumCount += bins[b].count;
+            }
+            rightCost[b] = accumCount > 0 ? accum.surfaceArea() * accumCount : 0.0f;
+        }
+
+        // Left-to-right sweep picks the cheapest plane
+        float bestCost = std::numeric_limits<float>::max();
+        int bestSplit = -1;
+        accumCount = 0;
+        for (int b = 0; b < BIN_COUNT - 1; ++b) {
+            if (bins[b].count > 0) {
+                accum = accumCount == 0 ? bins[b].bounds : AABB::merge(accum, bins[b].bounds);
+                accumCount += bins[b].count;
+            }
+            if (accumCount == 0 || accumCount == count) continue;
+            float cost = accum.surfaceArea() * accumCount + rightCost[b + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = b;
+            }
+        }
+
+        if (bestSplit >= 0) {
+            int32_t* mid = std::partition(leaves, leaves + count, [&](int32_t leaf) {
+                return binIndex(leaf) <= bestSplit;
+            });
+            splitCount = static_cast<int32_t>(mid - leaves);
+        }
+    }
+
+    // Degenerate distribution (all centroids coincide) - fall back to a median split
+    if (splitCount <= 0 || splitCount >= count) {
+        splitCount = count / 2;
+    }
+
+    int32_t child1 = buildSAHRange(leaves, splitCount);
+    int32_t child2 = buildSAHRange(leaves + splitCount, count - splitCount);
+
+    int32_t parent = allocateNode();
+    TreeNode& node = nodes[parent];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.aabb = AABB::merge(nodes[child1].aabb, nodes[child2].aabb);
+    node.height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+    nodes[child1].parent = parent;
+    nodes[child2].parent = parent;
+    return parent;
+}
+
+// === Statistics ===
+
+float DynamicAABBTree::getAreaRatio() const {
+    if (root == NULL_NODE) return 0.0f;
+
+    float rootArea = nodes[root].aabb.surfaceArea();
+    if (rootArea <= 0.0f) return 0.0f;
+
+    float totalArea = 0.0f;
+    for (const TreeNode& node : nodes) {
+        if (node.height <= 0) continue;  // Skip free nodes and leaves
+        totalArea += node.aabb.surfaceArea();
+    }
+    return totalArea / rootArea;
+}
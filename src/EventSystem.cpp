@@ -1,20 +1,103 @@
 #include "EventSystem.h"
+#include <atomic>
+#include <iostream>
+#include <cstdlib>
+
+EventTypeId EventTypes::allocateId() {
+    static std::atomic<EventTypeId> nextId{0};
+    EventTypeId id = nextId.fetch_add(1, std::memory_order_relaxed);
+    if (id >= MAX_TYPES) {
+        // Channels live in a fixed-size table (read lock-free by post()) - fail at startup
+        // instead of writing past it
+        std::cerr << "[EventSystem] Fatal: more than " << MAX_TYPES
+                  << " typed event types - raise EventTypes::MAX_TYPES" << std::endl;
+        std::abort();
+    }
+    return id;
+}
+
+uint32_t CoalesceTable::findOrInsert(uint64_t key, uint32_t index) {
+    // Keep load factor <= 0.5 so probe sequences stay short
+    if ((count + 1) * 2 > entries.size()) {
+        grow();
+    }
+    const size_t mask = entries.size() - 1;
+    size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    while (entries[slot].stamp == stamp) {
+        if (entries[slot].key == key) return entries[slot].index;
+        slot = (slot + 1) & mask;
+    }
+    entries[slot] = {key, index, stamp};
+    ++count;
+    return index;
+}
+
+void CoalesceTable::reset() {
+    count = 0;
+    if (++stamp == 0) {
+        // Stamp wrapped - old entries could look live again
+        for (Entry& entry : entries) entry.stamp = 0;
+        stamp = 1;
+    }
+}
+
+void CoalesceTable::grow() {
+    std::vector<Entry> old = std::move(entries);
+    bits = std::max<uint32_t>(bits + 1, 6);
+    entries.assign(size_t(1) << bits, Entry{0, 0, 0});
+    const size_t mask = entries.size() - 1;
+    for (const Entry& entry : old) {
+        if (entry.stamp != stamp) continue;
+        size_t slot = static_cast<size_t>((entry.key * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+        while (entries[slot].stamp == stamp) slot = (slot + 1) & mask;
+        entries[slot] = entry;
+    }
+}
 
 EventSystem::EventSystem()
     : EntitySystem("EventSystem") {
+    channels.resize(MAX_EVENT_TYPES);
 }
 
-void EventSystem::subscribe(const std::string& eventType, const EventCallback& callback) {
-    subscribers[eventType].push_back(callback);
+EventSubscription EventSystem::subscribe(const std::string& eventType, const EventCallback& callback) {
+    // The handle indexes legacySubscriptions, which records where the callback lives
+    EventSubscription subscription;
+    subscription.type = LEGACY_TYPE;
+    if (!freeLegacySlots.empty()) {
+        subscription.slot = freeLegacySlots.back();
+        freeLegacySlots.pop_back();
+    } else {
+        subscription.slot = static_cast<uint32_t>(legacySubscriptions.size());
+        legacySubscriptions.emplace_back();
+    }
+
+    LegacySubscription& legacy = legacySubscriptions[subscription.slot];
+    legacy.eventType = eventType;
+    legacy.slot = subscribers[eventType].add(EventHandler<std::shared_ptr<EventData>>(callback), legacy.generation);
+    subscription.generation = legacy.handleGeneration;
+    return subscription;
 }
 
-void EventSystem::unsubscribe(const std::string& eventType, const EventCallback& callback) {
-    auto it = subscribers.find(eventType);
-    if (it != subscribers.end()) {
-        auto& callbacks = it->second;
-        // Note: Simple implementation - in production, use proper callback comparison
-        // This is a simplified version
+bool EventSystem::unsubscribe(const EventSubscription& subscription) {
+    if (!subscription.isValid()) return false;
+
+    if (subscription.type == LEGACY_TYPE) {
+        if (subscription.slot >= legacySubscriptions.size()) return false;
+        LegacySubscription& legacy = legacySubscriptions[subscription.slot];
+        if (legacy.handleGeneration != subscription.generation) return false;
+
+        auto it = subscribers.find(legacy.eventType);
+        if (it == subscribers.end() || !it->second.remove(legacy.slot, legacy.generation)) return false;
+
+        // Release the record - stale copies of this handle no longer match
+        ++legacy.handleGeneration;
+        legacy.eventType.clear();
+        freeLegacySlots.push_back(subscription.slot);
+        return true;
     }
+
+    if (subscription.type >= channels.size() || !channels[subscription.type]) return false;
+    return channels[subscription.type]->unsubscribe(subscription.slot, subscription.generation);
 }
 
 void EventSystem::dispatch(const std::shared_ptr<EventData>& event) {
@@ -22,9 +105,9 @@ void EventSystem::dispatch(const std::shared_ptr<EventData>& event) {
     
     auto it = subscribers.find(event->getEventType());
     if (it != subscribers.end()) {
-        for (const auto& callback : it->second) {
-            callback(event);
-        }
+        it->second.forEach([&](const EventHandler<std::shared_ptr<EventData>>& handler) {
+            handler(event);
+        });
     }
 }
 
@@ -33,10 +116,64 @@ void EventSystem::queue(const std::shared_ptr<EventData>& event) {
 }
 
 void EventSystem::processQueue() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    // Merge cross-thread posts into this frame's queue (single consumer: this thread)
+    for (EventTypeId id : postableTypes) {
+        if (channels[id]->drainPosted(queueArenas[writeBuffer], writeBuffer)) {
+            queuedTypes[writeBuffer].push_back(id);
+        }
+    }
+
+    // Flip first so events queued by handlers land in the other buffer
+    const uint32_t readBuffer = writeBuffer;
+    writeBuffer ^= 1;
+    queuedEventCount = 0;
+
+    // Types still holding a backlog go first (their events are older), then this frame's
+    // types; a type in both is already listed. Stable sort keeps that order per class.
+    processOrder.assign(backlogTypes.begin(), backlogTypes.end());
+    for (EventTypeId id : queuedTypes[readBuffer]) {
+        if (channels[id]->getBacklogCount() == 0) {
+            processOrder.push_back(id);
+        }
+    }
+    std::stable_sort(processOrder.begin(), processOrder.end(), [this](EventTypeId a, EventTypeId b) {
+        return channels[a]->priority < channels[b]->priority;
+    });
+
+    EventDeadline deadline;
+    deadline.time = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float, std::milli>(frameBudgetMs));
+
+    backlogTypes.clear();
+    size_t backlog = 0;
+    for (EventTypeId id : processOrder) {
+        EventChannelBase& channel = *channels[id];
+        const bool budgeted = frameBudgetMs > 0.0f && channel.priority == EventPriority::Low;
+        if (size_t left = channel.processQueued(readBuffer, budgeted ? &deadline : nullptr)) {
+            backlogTypes.push_back(id);
+            backlog += left;
+        }
+    }
+    queuedTypes[readBuffer].clear();
+    queueArenas[readBuffer].reset();
+
     for (const auto& event : eventQueue) {
         dispatch(event);
     }
     eventQueue.clear();
+
+    const float elapsedMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    backlogStats.backlog = backlog;
+    backlogStats.backlogTypes = backlogTypes.size();
+    backlogStats.peakBacklog = std::max(backlogStats.peakBacklog, backlog);
+    backlogStats.framesWithBacklog = backlog > 0 ? backlogStats.framesWithBacklog + 1 : 0;
+    if (frameBudgetMs > 0.0f && elapsedMs > frameBudgetMs) {
+        ++backlogStats.framesOverBudget;
+    }
+    backlogStats.lastProcessMs = elapsedMs;
 }
 
 void EventSystem::initialize() {
@@ -47,6 +184,19 @@ void EventSystem::initialize() {
 void EventSystem::shutdown() {
     eventQueue.clear();
     subscribers.clear();
+    legacySubscriptions.clear();
+    freeLegacySlots.clear();
+    for (auto& channel : channels) {
+        channel.reset();
+    }
+    postableTypes.clear();
+    backlogTypes.clear();
+    backlogStats = EventBacklogStats{};
+    for (uint32_t buffer = 0; buffer < 2; ++buffer) {
+        queuedTypes[buffer].clear();
+        queueArenas[buffer].reset();
+    }
+    queuedEventCount = 0;
     initialized = false;
 }
 
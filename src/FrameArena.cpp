@@ -0,0 +1,39 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <new>
+
+FrameArena::FrameArena(size_t blockSize)
+    : blockSize(blockSize) {
+}
+
+FrameArena::~FrameArena() {
+    for (const Block& block : blocks) {
+        ::operator delete(block.data, std::align_val_t(MAX_ALIGNMENT));
+    }
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    // Walk forward through the retained blocks until one has room
+    while (currentBlock < blocks.size()) {
+        const Block& block = blocks[currentBlock];
+        size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+        if (aligned + bytes <= block.size) {
+            bytesUsed += aligned + bytes - offset;
+            offset = aligned + bytes;
+            return block.data + aligned;
+        }
+        // The tail of this block stays unused until the next reset
+        ++currentBlock;
+        offset = 0;
+    }
+
+    // Out of blocks - add one (block starts are MAX_ALIGNMENT aligned)
+    size_t size = std::max(blockSize, bytes);
+    Block block{static_cast<std::byte*>(::operator new(size, std::align_val_t(MAX_ALIGNMENT))), size};
+    blocks.push_back(block);
+    capacity += size;
+    currentBlock = blocks.size() - 1;
+    offset = bytes;
+    bytesUsed += bytes;
+    return block.data;
+}
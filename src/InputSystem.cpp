@@ -1,6 +1,10 @@
 #include "InputSystem.h"
 #include "InputComponent.h"
+#include "CollisionComponent.h"
+#include "CollisionSystem.h"
 #include "GameEntity.h"
+#include "RenderCollector.h"
+#include "TransformComponent.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
 
@@ -24,6 +28,52 @@ void InputSystem::update(float deltaTime) {
     pollInputEvents();
 }
 
+std::shared_ptr<GameEntity> InputSystem::pickEntity(double mouseX, double mouseY) const {
+    auto collision = collisionSystem.lock();
+    if (!collision || !window) return nullptr;
+
+    int width = 0, height = 0;
+    glfwGetWindowSize(window, &width, &height);
+    if (width <= 0 || height <= 0) return nullptr;
+
+    // Cursor -> NDC -> world: cast from the near plane to the far plane
+    float ndcX = static_cast<float>(2.0 * mouseX / width - 1.0);
+    float ndcY = static_cast<float>(1.0 - 2.0 * mouseY / height);
+    glm::mat4 inverse = glm::inverse(pickingProjection);
+    glm::vec4 nearPoint = inverse * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverse * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 direction = glm::vec3(farPoint) / farPoint.w - origin;
+
+    std::vector<RaycastHit> hits;
+    if (collision->raycast(origin, direction, glm::length(direction), pickLayerMask, QueryMode::All, hits) == 0) {
+        return nullptr;
+    }
+
+    // Hits are sorted by distance - among the nearest (coplanar) ones the collider drawn
+    // last is the one visible under the cursor
+    auto storage = collision->getStorage();
+    auto collector = renderCollector.lock();
+    std::shared_ptr<GameEntity> picked;
+    uint64_t pickedOrder = 0;
+    for (const RaycastHit& hit : hits) {
+        if (hit.distance != hits[0].distance) break;
+
+        auto entity = storage->getOwner(hit.index);
+        if (!entity) continue;
+        uint64_t order = hit.index;
+        if (collector) {
+            auto transform = entity->getComponent<TransformComponent>();
+            order = transform ? collector->getDrawOrder(transform->getStorageHandle()) : 0;
+        }
+        if (!picked || order >= pickedOrder) {
+            picked = entity;
+            pickedOrder = order;
+        }
+    }
+    return picked;
+}
+
 void InputSystem::pollInputEvents() {
     auto worldPtr = world.lock();
     if (!worldPtr) return;
@@ -39,6 +89,58 @@ void InputSystem::pollInputEvents() {
         previousMouseY = mouseY;
     }
 
+    // Detect state changes once per poll, then deliver them to entities
+    // We check commonly used keys - in a real implementation, 
+    // you might want to track which keys are registered in callbacks
+    static const int keysToCheck[] = {
+        GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D,
+        GLFW_KEY_SPACE, GLFW_KEY_ESCAPE, GLFW_KEY_ENTER,
+        GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_DOWN,
+        GLFW_KEY_LEFT_SHIFT, GLFW_KEY_LEFT_CONTROL,
+        GLFW_KEY_Q, GLFW_KEY_E, GLFW_KEY_R, GLFW_KEY_F,
+        GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3, GLFW_KEY_4, GLFW_KEY_5
+    };
+
+    keyChanges.clear();
+    for (int key : keysToCheck) {
+        int state = glfwGetKey(window, key);
+        int& prevState = previousKeyStates[key];
+        if (state != prevState) {
+            prevState = state;
+            keyChanges.emplace_back(key, state);
+        }
+    }
+
+    static const int buttonsToCheck[] = {
+        GLFW_MOUSE_BUTTON_LEFT,
+        GLFW_MOUSE_BUTTON_RIGHT,
+        GLFW_MOUSE_BUTTON_MIDDLE
+    };
+
+    mouseButtonChanges.clear();
+    for (int button : buttonsToCheck) {
+        int state = glfwGetMouseButton(window, button);
+        int& prevState = previousMouseButtonStates[button];
+        if (state != prevState) {
+            prevState = state;
+            mouseButtonChanges.emplace_back(button, state);
+        }
+    }
+
+    // Mouse buttons go only to the entity under the cursor
+    bool picking = !collisionSystem.expired();
+    if (picking && !mouseButtonChanges.empty()) {
+        auto picked = pickEntity(mouseX, mouseY);
+        auto inputComponent = picked ? picked->getComponent<InputComponent>() : nullptr;
+        if (inputComponent) {
+            for (const auto& [button, action] : mouseButtonChanges) {
+                inputComponent->processMouseButton(button, action, 0);
+            }
+        }
+    }
+
+    if (!mouseMoved && keyChanges.empty() && (picking || mouseButtonChanges.empty())) return;
+
     // Iterate through all entities in the world
     // Note: This simple iteration approach is consistent with other systems (e.g., MobilitySwitcherSystem).
     // In a more optimized implementation, you could maintain a separate collection of entities with InputComponent.
@@ -57,42 +159,14 @@ void InputSystem::pollInputEvents() {
             inputComponent->processMouseMove(mouseX, mouseY);
         }
 
-        // Check for key state changes
-        // We check commonly used keys - in a real implementation, 
-        // you might want to track which keys are registered in callbacks
-        static const int keysToCheck[] = {
-            GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D,
-            GLFW_KEY_SPACE, GLFW_KEY_ESCAPE, GLFW_KEY_ENTER,
-            GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_DOWN,
-            GLFW_KEY_LEFT_SHIFT, GLFW_KEY_LEFT_CONTROL,
-            GLFW_KEY_Q, GLFW_KEY_E, GLFW_KEY_R, GLFW_KEY_F,
-            GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3, GLFW_KEY_4, GLFW_KEY_5
-        };
-
-        for (int key : keysToCheck) {
-            int state = glfwGetKey(window, key);
-            int prevState = previousKeyStates[key];
-            
-            if (state != prevState) {
-                previousKeyStates[key] = state;
-                inputComponent->processKey(key, state, 0);
-            }
+        for (const auto& [key, action] : keyChanges) {
+            inputComponent->processKey(key, action, 0);
         }
 
-        // Check for mouse button state changes
-        static const int buttonsToCheck[] = {
-            GLFW_MOUSE_BUTTON_LEFT,
-            GLFW_MOUSE_BUTTON_RIGHT,
-            GLFW_MOUSE_BUTTON_MIDDLE
-        };
-
-        for (int button : buttonsToCheck) {
-            int state = glfwGetMouseButton(window, button);
-            int prevState = previousMouseButtonStates[button];
-            
-            if (state != prevState) {
-                previousMouseButtonStates[button] = state;
-                inputComponent->processMouseButton(button, state, 0);
+        // Without a collision system there is nothing to pick with - broadcast
+        if (!picking) {
+            for (const auto& [button, action] : mouseButtonChanges) {
+                inputComponent->processMouseButton(button, action, 0);
             }
         }
     }
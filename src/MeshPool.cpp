@@ -0,0 +1,60 @@
+#include "MeshPool.h"
+#include <iostream>
+
+MeshPool::~MeshPool() {
+    cleanup();
+}
+
+void MeshPool::initialize(size_t vertexCapacity, size_t indexCapacity) {
+    if (vertexVBO) {
+        return;  // Already initialized
+    }
+
+    // Traditional (non-persistent) buffers grow in place - VAO attachments stay valid
+    vertexVBO = std::make_unique<VBO<glm::vec3>>(GL_STATIC_DRAW);
+    indexVBO = std::make_unique<VBO<uint32_t>>(GL_STATIC_DRAW);
+    vertexVBO->initialize(vertexCapacity);
+    indexVBO->initialize(indexCapacity);
+}
+
+MeshPool::MeshID MeshPool::registerMesh(const MeshPtr& mesh) {
+    if (!mesh || !vertexVBO) {
+        return INVALID_MESH;
+    }
+
+    auto it = meshToID.find(mesh);
+    if (it != meshToID.end()) {
+        return it->second;
+    }
+
+    const auto& vertices = mesh->getVertices();
+    const auto& indices = mesh->getIndices();
+    if (vertices.empty() || indices.empty()) {
+        std::cerr << "[MeshPool] Warning: Ignoring empty mesh" << std::endl;
+        return INVALID_MESH;
+    }
+
+    // Append both streams; indices stay mesh-relative (baseVertex rebases them)
+    MeshRange range;
+    range.firstIndex = static_cast<uint32_t>(indexCount);
+    range.indexCount = static_cast<uint32_t>(indices.size());
+    range.baseVertex = static_cast<int32_t>(vertexCount);
+    vertexVBO->uploadRange(vertexCount, vertices.data(), vertices.size());
+    indexVBO->uploadRange(indexCount, indices.data(), indices.size());
+    vertexCount += vertices.size();
+    indexCount += indices.size();
+
+    MeshID id = static_cast<MeshID>(ranges.size());
+    ranges.push_back(range);
+    meshToID.emplace(mesh, id);
+    return id;
+}
+
+void MeshPool::cleanup() {
+    vertexVBO.reset();
+    indexVBO.reset();
+    ranges.clear();
+    meshToID.clear();
+    vertexCount = 0;
+    indexCount = 0;
+}
@@ -0,0 +1,205 @@
+#include "Narrowphase.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr size_t PAIR_GRAIN = 1024;
+    constexpr float EPSILON = 1e-6f;
+
+    glm::vec3 toVec3(const glm::vec2& v) {
+        return glm::vec3(v.x, v.y, 0.0f);
+    }
+
+    glm::vec2 xy(const glm::vec4& v) {
+        return glm::vec2(v.x, v.y);
+    }
+
+    glm::vec2 xy(const glm::vec3& v) {
+        return glm::vec2(v.x, v.y);
+    }
+
+    // Box vertex furthest along dir
+    glm::vec2 support(const glm::vec2& center, const glm::vec2& axisX, const glm::vec2& axisY, const glm::vec2& dir) {
+        return center + (glm::dot(axisX, dir) >= 0.0f ? axisX : -axisX)
+                      + (glm::dot(axisY, dir) >= 0.0f ? axisY : -axisY);
+    }
+}
+
+Narrowphase::WorldShape Narrowphase::makeWorldShape(const CollisionDataStorage& storage,
+                                                    const TransformDataStorage* transforms, uint32_t slot) {
+    WorldShape shape;
+    shape.type = storage.getAllShapes()[slot];
+
+    SoaHandle handle = storage.getAllTransformHandles()[slot];
+    if (transforms && transforms->isValid(handle)) {
+        const glm::mat4& m = transforms->getAllWorldMatrices()[transforms->getRow(handle)];
+        glm::vec3 localMin = storage.getAllLocalMins()[slot];
+        glm::vec3 localMax = storage.getAllLocalMaxs()[slot];
+        glm::vec3 center = (localMin + localMax) * 0.5f;
+        glm::vec3 extents = (localMax - localMin) * 0.5f;
+
+        shape.center = xy(m * glm::vec4(center, 1.0f));
+        shape.axisX = xy(m[0]) * extents.x;
+        shape.axisY = xy(m[1]) * extents.y;
+        float scale = std::max(glm::length(xy(m[0])), glm::length(xy(m[1])));
+        shape.radius = std::min(extents.x, extents.y) * scale;
+    } else {
+        // Unbound: the world AABB is the shape
+        AABB bounds = storage.getBounds(slot);
+        glm::vec3 extents = bounds.extents();
+        shape.center = xy(bounds.center());
+        shape.axisX = glm::vec2(extents.x, 0.0f);
+        shape.axisY = glm::vec2(0.0f, extents.y);
+        shape.radius = std::min(extents.x, extents.y);
+    }
+    return shape;
+}
+
+bool Narrowphase::boxBox(const WorldShape& a, const WorldShape& b, Contact& contact) {
+    // Separating axis test over the 4 face normals; keep the axis of least penetration
+    const glm::vec2 axes[4] = {a.axisX, a.axisY, b.axisX, b.axisY};
+    glm::vec2 delta = b.center - a.center;
+
+    float minOverlap = std::numeric_limits<float>::max();
+    glm::vec2 bestNormal(1.0f, 0.0f);
+    for (const glm::vec2& axis : axes) {
+        float length = glm::length(axis);
+        if (length < EPSILON) continue;  // Degenerate (zero scale) axis
+        glm::vec2 n = axis / length;
+
+        float radiusA = std::abs(glm::dot(a.axisX, n)) + std::abs(glm::dot(a.axisY, n));
+        float radiusB = std::abs(glm::dot(b.axisX, n)) + std::abs(glm::dot(b.axisY, n));
+        float distance = glm::dot(delta, n);
+        float overlap = radiusA + radiusB - std::abs(distance);
+        if (overlap < 0.0f) return false;
+
+        if (overlap < minOverlap) {
+            minOverlap = overlap;
+            bestNormal = distance < 0.0f ? -n : n;
+        }
+    }
+
+    if (minOverlap == std::numeric_limits<float>::max()) {
+        minOverlap = 0.0f;  // Both boxes degenerate - touching points
+    }
+
+    // Midpoint of the deepest vertices of each box along the normal
+    glm::vec2 pointA = support(a.center, a.axisX, a.axisY, bestNormal);
+    glm::vec2 pointB = support(b.center, b.axisX, b.axisY, -bestNormal);
+
+    contact.normal = toVec3(bestNormal);
+    contact.depth = minOverlap;
+    contact.point = toVec3((pointA + pointB) * 0.5f);
+    return true;
+}
+
+bool Narrowphase::circleCircle(const WorldShape& a, const WorldShape& b, Contact& contact) {
+    glm::vec2 delta = b.center - a.center;
+    float distance = glm::length(delta);
+    float depth = a.radius + b.radius - distance;
+    if (depth < 0.0f) return false;
+
+    glm::vec2 normal = distance > EPSILON ? delta / distance : glm::vec2(1.0f, 0.0f);
+    contact.normal = toVec3(normal);
+    contact.depth = depth;
+    contact.point = toVec3(a.center + normal * (a.radius - depth * 0.5f));
+    return true;
+}
+
+bool Narrowphase::boxCircle(const WorldShape& box, const WorldShape& circle, Contact& contact) {
+    float halfX = glm::length(box.axisX);
+    float halfY = glm::length(box.axisY);
+    glm::vec2 unitX = halfX > EPSILON ? box.axisX / halfX : glm::vec2(1.0f, 0.0f);
+    glm::vec2 unitY = halfY > EPSILON ? box.axisY / halfY : glm::vec2(-unitX.y, unitX.x);
+
+    // Circle center in box space
+    glm::vec2 delta = circle.center - box.center;
+    float localX = glm::dot(delta, unitX);
+    float localY = glm::dot(delta, unitY);
+
+    if (std::abs(localX) <= halfX && std::abs(localY) <= halfY) {
+        // Center inside the box - push out through the nearest face
+        float gapX = halfX - std::abs(localX);
+        float gapY = halfY - std::abs(localY);
+        glm::vec2 normal = gapX < gapY ? (localX < 0.0f ? -unitX : unitX)
+                                       : (localY < 0.0f ? -unitY : unitY);
+        contact.normal = toVec3(normal);
+        contact.depth = circle.radius + std::min(gapX, gapY);
+        contact.point = toVec3(circle.center);
+        return true;
+    }
+
+    glm::vec2 closest = box.center + unitX * std::clamp(localX, -halfX, halfX)
+                                   + unitY * std::clamp(localY, -halfY, halfY);
+    glm::vec2 offset = circle.center - closest;
+    float distance = glm::length(offset);
+    if (distance > circle.radius) return false;
+
+    contact.normal = toVec3(distance > EPSILON ? offset / distance : unitX);
+    contact.depth = circle.radius - distance;
+    contact.point = toVec3(closest);
+    return true;
+}
+
+void Narrowphase::run(const CollisionDataStorage& storage, const TransformDataStorage* transforms,
+                      const std::vector<CollisionPair>& pairs, std::vector<Contact>& outContacts,
+                      ThreadPool* pool) {
+    outContacts.clear();
+    if (pairs.empty()) return;
+
+    // One output buffer per chunk, concatenated in chunk order
+    size_t chunkCount = ThreadPool::getChunkCount(pairs.size(), PAIR_GRAIN);
+    if (chunkContacts.size() < chunkCount) {
+        chunkContacts.resize(chunkCount);
+    }
+    for (auto& chunk : chunkContacts) {
+        chunk.clear();
+    }
+
+    auto processRange = [&](size_t begin, size_t end, uint32_t) {
+        std::vector<Contact>& local = chunkContacts[begin / PAIR_GRAIN];
+
+        for (size_t i = begin; i < end; ++i) {
+            const CollisionPair& pair = pairs[i];
+            WorldShape shapeA = makeWorldShape(storage, transforms, pair.a);
+            WorldShape shapeB = makeWorldShape(storage, transforms, pair.b);
+
+            Contact contact;
+            bool hit = false;
+            if (shapeA.type == CollisionShape::Box && shapeB.type == CollisionShape::Box) {
+                hit = boxBox(shapeA, shapeB, contact);
+            } else if (shapeA.type == CollisionShape::Circle && shapeB.type == CollisionShape::Circle) {
+                hit = circleCircle(shapeA, shapeB, contact);
+            } else if (shapeA.type == CollisionShape::Box) {
+                hit = boxCircle(shapeA, shapeB, contact);
+            } else {
+                // Circle vs box: test box-first, then flip the normal to point from a to b
+                hit = boxCircle(shapeB, shapeA, contact);
+                contact.normal = -contact.normal;
+            }
+
+            if (hit) {
+                contact.a = pair.a;
+                contact.b = pair.b;
+                local.push_back(contact);
+            }
+        }
+    };
+
+    if (pool) {
+        pool->parallelFor(pairs.size(), PAIR_GRAIN, processRange);
+    } else {
+        for (size_t begin = 0; begin < pairs.size(); begin += PAIR_GRAIN) {
+            processRange(begin, std::min(pairs.size(), begin + PAIR_GRAIN), 0);
+        }
+    }
+
+    size_t total = 0;
+    for (size_t c = 0; c < chunkCount; ++c) total += chunkContacts[c].size();
+    outContacts.reserve(total);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        outContacts.insert(outContacts.end(), chunkContacts[c].begin(), chunkContacts[c].end());
+    }
+}
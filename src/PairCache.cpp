@@ -0,0 +1,141 @@
+#include "PairCache.h"
+#include <algorithm>
+
+namespace {
+    bool pairLess(const CollisionPair& x, const CollisionPair& y) {
+        return x.a < y.a || (x.a == y.a && x.b < y.b);
+    }
+}
+
+uint32_t PairCache::findSlot(uint64_t key) const {
+    const uint32_t mask = static_cast<uint32_t>(table.size()) - 1;
+    uint32_t slot = homeSlot(key);
+    while (table[slot] != EMPTY && keyOf(pairs[table[slot]]) != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+bool PairCache::contains(uint32_t a, uint32_t b) const {
+    if (table.empty()) return false;
+    if (a > b) std::swap(a, b);
+    return table[findSlot(makeKey(a, b))] != EMPTY;
+}
+
+void PairCache::grow() {
+    // Keep load factor <= 0.5 so probe sequences stay short
+    tableBits = std::max<uint32_t>(tableBits + 1, 6);
+    table.assign(size_t(1) << tableBits, EMPTY);
+    for (uint32_t i = 0; i < pairs.size(); ++i) {
+        table[findSlot(keyOf(pairs[i]))] = i;
+    }
+}
+
+void PairCache::insertAt(uint32_t slot, const CollisionPair& pair) {
+    table[slot] = static_cast<uint32_t>(pairs.size());
+    pairs.push_back(pair);
+    stamps.push_back(frame);
+
+    uint32_t maxSlot = std::max(pair.a, pair.b);
+    if (partners.size() <= maxSlot) {
+        partners.resize(maxSlot + 1);
+    }
+    partners[pair.a].push_back(pair.b);
+    partners[pair.b].push_back(pair.a);
+}
+
+void PairCache::unlinkPartner(uint32_t slot, uint32_t other) {
+    // Partner lists are short (local contact count) - linear find, swap-erase
+    std::vector<uint32_t>& list = partners[slot];
+    auto it = std::find(list.begin(), list.end(), other);
+    *it = list.back();
+    list.pop_back();
+}
+
+bool PairCache::add(uint32_t a, uint32_t b) {
+    if (a > b) std::swap(a, b);
+    if ((pairs.size() + 1) * 2 > table.size()) {
+        grow();
+    }
+    uint32_t slot = findSlot(makeKey(a, b));
+    if (table[slot] != EMPTY) return false;
+    insertAt(slot, CollisionPair{a, b});
+    return true;
+}
+
+void PairCache::removeAt(uint32_t denseIndex) {
+    const uint32_t mask = static_cast<uint32_t>(table.size()) - 1;
+
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    uint32_t hole = findSlot(keyOf(pairs[denseIndex]));
+    uint32_t slot = (hole + 1) & mask;
+    while (table[slot] != EMPTY) {
+        uint32_t home = homeSlot(keyOf(pairs[table[slot]]));
+        // Move the entry into the hole unless its home lies cyclically in (hole, slot]
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            table[hole] = table[slot];
+            hole = slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    table[hole] = EMPTY;
+
+    unlinkPartner(pairs[denseIndex].a, pairs[denseIndex].b);
+    unlinkPartner(pairs[denseIndex].b, pairs[denseIndex].a);
+
+    // Swap-remove from the dense array and repoint the moved pair's slot
+    uint32_t last = static_cast<uint32_t>(pairs.size()) - 1;
+    if (denseIndex != last) {
+        pairs[denseIndex] = pairs[last];
+        stamps[denseIndex] = stamps[last];
+        table[findSlot(keyOf(pairs[denseIndex]))] = denseIndex;
+    }
+    pairs.pop_back();
+    stamps.pop_back();
+}
+
+void PairCache::update(const std::vector<CollisionPair>& framePairs,
+                       std::vector<CollisionPair>& outBegins, std::vector<CollisionPair>& outEnds) {
+    outBegins.clear();
+    outEnds.clear();
+    ++frame;
+
+    // 1. Stamp pairs seen this frame, insert new ones
+    for (const CollisionPair& pair : framePairs) {
+        if ((pairs.size() + 1) * 2 > table.size()) {
+            grow();
+        }
+        uint64_t key = keyOf(pair);
+        uint32_t slot = findSlot(key);
+        if (table[slot] != EMPTY) {
+            stamps[table[slot]] = frame;
+            continue;
+        }
+        insertAt(slot, pair);
+        outBegins.push_back(pair);
+    }
+
+    // 2. Pairs not stamped this frame ended (walk backwards so swap-remove stays in the visited range)
+    for (uint32_t i = static_cast<uint32_t>(pairs.size()); i-- > 0;) {
+        if (stamps[i] != frame) {
+            outEnds.push_back(pairs[i]);
+            removeAt(i);
+        }
+    }
+
+    sortPairs(outBegins);
+    sortPairs(outEnds);
+}
+
+void PairCache::sortPairs(std::vector<CollisionPair>& pairs) {
+    // Transition batches are small - sorting them is cheap
+    std::sort(pairs.begin(), pairs.end(), pairLess);
+}
+
+void PairCache::clear() {
+    pairs.clear();
+    stamps.clear();
+    table.clear();
+    partners.clear();
+    tableBits = 0;
+}
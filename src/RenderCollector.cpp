@@ -3,6 +3,7 @@
 #include "GameEntity.h"
 #include "RenderComponent.h"
 #include "TransformComponent.h"
+#include "TransformComputeSystem.h"
 #include <iostream>
 
 RenderCollector::RenderCollector(const std::string& name)
@@ -15,8 +16,9 @@ void RenderCollector::initialize() {
     // Pre-allocate buffers for performance
     staticModelMatrices.reserve(100);
     staticMaterialIDs.reserve(100);
-    movableModelMatrices.reserve(100);
+    staticMeshIDs.reserve(100);
     movableMaterialIDs.reserve(100);
+    movableMeshIDs.reserve(100);
     uniqueStaticMaterials.reserve(20);
     uniqueDynamicMaterials.reserve(20);
     staticEntities.reserve(100);
@@ -46,13 +48,18 @@ void RenderCollector::collectAndRender() {
         // Clear all data
         staticModelMatrices.clear();
         staticMaterialIDs.clear();
-        movableModelMatrices.clear();
+        staticMeshIDs.clear();
         movableMaterialIDs.clear();
+        movableMeshIDs.clear();
         uniqueStaticMaterials.clear();
         uniqueDynamicMaterials.clear();
         materialToID.clear();
         staticEntities.clear();
         movableEntities.clear();
+        staticHandles.clear();
+        movableHandles.clear();
+        instanceSlots.clear();
+        materialsByID.clear();
         
         // Collect all entities with both RenderComponent and TransformComponent
         const auto& objects = worldPtr->getObjects();
@@ -80,6 +87,7 @@ void RenderCollector::collectAndRender() {
                     // New material, assign new ID and add to appropriate list
                     matID = static_cast<unsigned int>(materialToID.size());
                     materialToID[material] = matID;
+                    materialsByID.push_back(material);
                     
                     if (material->isStatic()) {
                         uniqueStaticMaterials.push_back(material);
@@ -88,25 +96,36 @@ void RenderCollector::collectAndRender() {
                     }
                 }
 
-                // Get transform matrix
-                glm::mat4 worldMatrix = transformComp->getWorldMatrix();
-                
+                // Meshes are registered in the shared mesh pool on first use (nullptr = quad)
+                unsigned int meshID = renderSystemPtr->registerMesh(renderComp->getMesh());
+
                 // Separate by mobility type
                 TransformMobility mobility = transformComp->getMobility();
+                TransformDataStorage::HandleID handle = transformComp->getStorageHandle();
                 if (mobility == TransformMobility::Static) {
                     // Static objects - store entity reference and data
+                    setSlot(handle, InstanceSet::Static, static_cast<uint32_t>(staticEntities.size()));
                     staticEntities.push_back(entity);
-                    staticModelMatrices.push_back(worldMatrix);
+                    staticHandles.push_back(handle);
+                    staticModelMatrices.push_back(transformComp->getWorldMatrix());
                     staticMaterialIDs.push_back(matID);
+                    staticMeshIDs.push_back(meshID);
                 } else {
                     // Movable objects - store entity reference and data
+                    setSlot(handle, InstanceSet::Movable, static_cast<uint32_t>(movableEntities.size()));
                     movableEntities.push_back(entity);
-                    movableModelMatrices.push_back(worldMatrix);
+                    movableHandles.push_back(handle);
                     movableMaterialIDs.push_back(matID);  // Material ID never changes!
+                    movableMeshIDs.push_back(meshID);
                 }
             }
         }
         
+        // Everything is freshly sorted by mobility - earlier changes are already reflected,
+        // and the static buffers must be uploaded again in full
+        TransformComponent::getSharedStorage()->clearMobilityChanges();
+        renderSystemPtr->markStaticDataDirty();
+
         dataInitialized = true;
         std::cout << "[RenderCollector] Static data initialized: "
                   << staticEntities.size() << " static, "
@@ -114,36 +133,175 @@ void RenderCollector::collectAndRender() {
                   << uniqueStaticMaterials.size() << " static materials, "
                   << uniqueDynamicMaterials.size() << " dynamic materials" << std::endl;
     } else {
-        // After first frame: Only update movable matrices (not VBO IDs, not materials!)
-        movableModelMatrices.clear();
-        for (size_t i = 0; i < movableEntities.size(); ++i) {
-            auto entity = movableEntities[i];
-            auto transformComp = entity->getComponent<TransformComponent>();
-            if (transformComp) {
-                movableModelMatrices.push_back(transformComp->getWorldMatrix());
-            }
-        }
-        // Note: movableMaterialIDs never changes after initialization!
+        // Entities that switched mobility move between the sets one by one
+        applyMobilityChanges(*TransformComponent::getSharedStorage(), *renderSystemPtr);
     }
 
-    // Extract colors from deduplicated materials for rendering (do once on init)
-    // Static materials (never changes after initialization)
-    std::vector<glm::vec4> staticMaterialColors;
-    staticMaterialColors.reserve(uniqueStaticMaterials.size());
-    for (const auto& mat : uniqueStaticMaterials) {
-        staticMaterialColors.push_back(mat->getColor());
+    // Movable matrices: gathered by transform handle straight from the SOA storage into
+    // the mapped GPU buffer - no component lookups, no intermediate copy
+    // GPU-driven mode computes them on the GPU instead and only streams matrix IDs
+    // Note: movableMaterialIDs/movableMeshIDs only change when an instance migrates
+    auto computePtr = transformCompute.lock();
+    if (computePtr && computePtr->isEnabled() && computePtr->isAvailable()) {
+        computeMovableMatrices(*TransformComponent::getSharedStorage(), *renderSystemPtr, *computePtr);
+    } else {
+        gatherMovableMatrices(*TransformComponent::getSharedStorage(), *renderSystemPtr);
     }
-    
-    // Dynamic materials (never changes after initialization)
-    std::vector<glm::vec4> dynamicMaterialColors;
-    dynamicMaterialColors.reserve(uniqueDynamicMaterials.size());
-    for (const auto& mat : uniqueDynamicMaterials) {
-        dynamicMaterialColors.push_back(mat->getColor());
+
+    // Extract colors from deduplicated materials for rendering
+    // Material IDs are shared by both sets (an instance keeps its ID when it migrates),
+    // so both material SSBOs hold the full table indexed by ID
+    std::vector<glm::vec4> materialColors;
+    materialColors.reserve(materialsByID.size());
+    for (const auto& mat : materialsByID) {
+        materialColors.push_back(mat->getColor());
     }
 
     // Batch render with dual SSBO/VBO architecture
-    if (!staticModelMatrices.empty() || !movableModelMatrices.empty()) {
-        renderSystemPtr->renderBatch(staticModelMatrices, staticMaterialColors, staticMaterialIDs,
-                                      movableModelMatrices, dynamicMaterialColors, movableMaterialIDs);
+    if (!staticModelMatrices.empty() || !movableHandles.empty()) {
+        renderSystemPtr->renderBatch(staticModelMatrices, materialColors, staticMaterialIDs, staticMeshIDs,
+                                      materialColors, movableMaterialIDs, movableMeshIDs);
+    }
+}
+
+void RenderCollector::gatherMovableMatrices(TransformDataStorage& storage, RenderSystem& renderSys) {
+    // Bring every dirty movable world matrix up to date in one pass over the storage
+    storage.updateMovableWorldMatrices();
+
+    glm::mat4* gpuMatrices = renderSys.mapDynamicMatrices(movableHandles.size());
+    if (!gpuMatrices) return;
+
+    auto worldMatrices = storage.getAllWorldMatrices();
+    for (size_t i = 0; i < movableHandles.size(); ++i) {
+        TransformDataStorage::HandleID handle = movableHandles[i];
+        gpuMatrices[i] = storage.isValid(handle) ? worldMatrices[storage.getRow(handle)] : glm::mat4(1.0f);
+    }
+}
+
+void RenderCollector::computeMovableMatrices(TransformDataStorage& storage, RenderSystem& renderSys,
+                                             TransformComputeSystem& computeSys) {
+    if (movableHandles.empty()) return;
+
+    // Dirty TRS rows only, then one dispatch per hierarchy level
+    computeSys.syncFromStorage(storage);
+    computeSys.computeWorldMatrices();
+
+    unsigned int* matrixIDs = renderSys.mapDynamicMatrixIDs(movableHandles.size(), computeSys.getWorldMatrixSSBO());
+    if (!matrixIDs) return;
+
+    // GPU rows mirror storage rows; a destroyed transform reads the reserved identity row
+    // (like the CPU path) instead of another entity's matrix until the next rebuild
+    const uint32_t identityRow = computeSys.getIdentityRow();
+    for (size_t i = 0; i < movableHandles.size(); ++i) {
+        TransformDataStorage::HandleID handle = movableHandles[i];
+        matrixIDs[i] = storage.isValid(handle) ? storage.getRow(handle) : identityRow;
+    }
+}
+
+void RenderCollector::applyMobilityChanges(TransformDataStorage& storage, RenderSystem& renderSys) {
+    for (TransformDataStorage::HandleID handle : storage.getMobilityChanges()) {
+        // Stale handles and entities the collector does not draw are skipped
+        if (!storage.isValid(handle)) continue;
+        InstanceSlot* slot = findSlot(handle);
+        if (!slot) continue;
+
+        // A handle can be logged several times per frame - only the final state matters
+        const bool isStatic = storage.getMobility(handle) == 0;
+        if (isStatic && slot->set == InstanceSet::Movable) {
+            migrateToStatic(slot->index, renderSys);
+        } else if (!isStatic && slot->set == InstanceSet::Static) {
+            migrateToMovable(slot->index, renderSys);
+        }
+    }
+    storage.clearMobilityChanges();
+}
+
+void RenderCollector::migrateToMovable(uint32_t staticIndex, RenderSystem& renderSys) {
+    // Append to the movable set (its matrices are refreshed and re-uploaded every frame)
+    setSlot(staticHandles[staticIndex], InstanceSet::Movable, static_cast<uint32_t>(movableEntities.size()));
+    movableEntities.push_back(std::move(staticEntities[staticIndex]));
+    movableHandles.push_back(staticHandles[staticIndex]);
+    movableMaterialIDs.push_back(staticMaterialIDs[staticIndex]);
+    movableMeshIDs.push_back(staticMeshIDs[staticIndex]);
+
+    // Swap-remove from the static set - the GPU side patches the hole, its mesh bucket
+    // and that mesh's draw command
+    const uint32_t last = static_cast<uint32_t>(staticEntities.size() - 1);
+    renderSys.removeStaticInstance(staticIndex, staticModelMatrices[last]);
+    if (staticIndex != last) {
+        staticEntities[staticIndex] = std::move(staticEntities[last]);
+        staticHandles[staticIndex] = staticHandles[last];
+        staticModelMatrices[staticIndex] = staticModelMatrices[last];
+        staticMaterialIDs[staticIndex] = staticMaterialIDs[last];
+        staticMeshIDs[staticIndex] = staticMeshIDs[last];
+        setSlot(staticHandles[staticIndex], InstanceSet::Static, staticIndex);
+    }
+    staticEntities.pop_back();
+    staticHandles.pop_back();
+    staticModelMatrices.pop_back();
+    staticMaterialIDs.pop_back();
+    staticMeshIDs.pop_back();
+}
+
+void RenderCollector::migrateToStatic(uint32_t movableIndex, RenderSystem& renderSys) {
+    // setMobility(Static) cached the final world matrix - that is what the static set keeps
+    glm::mat4 worldMatrix(1.0f);
+    if (auto transformComp = movableEntities[movableIndex]->getComponent<TransformComponent>()) {
+        worldMatrix = transformComp->getWorldMatrix();
+    }
+
+    // Append to the static set and upload just the new slot
+    const uint32_t staticIndex = static_cast<uint32_t>(staticEntities.size());
+    setSlot(movableHandles[movableIndex], InstanceSet::Static, staticIndex);
+    staticEntities.push_back(std::move(movableEntities[movableIndex]));
+    staticHandles.push_back(movableHandles[movableIndex]);
+    staticModelMatrices.push_back(worldMatrix);
+    staticMaterialIDs.push_back(movableMaterialIDs[movableIndex]);
+    staticMeshIDs.push_back(movableMeshIDs[movableIndex]);
+    renderSys.addStaticInstance(staticIndex, worldMatrix, staticMaterialIDs.back(), staticMeshIDs.back());
+
+    // Swap-remove from the movable set (CPU only, the dynamic buffers are rewritten every frame)
+    const uint32_t last = static_cast<uint32_t>(movableEntities.size() - 1);
+    if (movableIndex != last) {
+        movableEntities[movableIndex] = std::move(movableEntities[last]);
+        movableHandles[movableIndex] = movableHandles[last];
+        movableMaterialIDs[movableIndex] = movableMaterialIDs[last];
+        movableMeshIDs[movableIndex] = movableMeshIDs[last];
+        setSlot(movableHandles[movableIndex], InstanceSet::Movable, movableIndex);
+    }
+    movableEntities.pop_back();
+    movableHandles.pop_back();
+    movableMaterialIDs.pop_back();
+    movableMeshIDs.pop_back();
+}
+
+uint64_t RenderCollector::getDrawOrder(TransformDataStorage::HandleID handle) const {
+    if (handle.index >= instanceSlots.size()) return 0;
+    const InstanceSlot& slot = instanceSlots[handle.index];
+    if (slot.set == InstanceSet::None || slot.generation != handle.generation) return 0;
+
+    // Static: the instance's entry in the static ID streams (mesh buckets in mesh ID order)
+    if (slot.set == InstanceSet::Static) {
+        auto renderSystemPtr = renderSystem.lock();
+        return renderSystemPtr ? renderSystemPtr->getStaticDrawPosition(slot.index) : slot.index;
+    }
+
+    // Movable: (mesh, index) after every static instance - the counting sort is stable within a mesh
+    uint64_t meshID = movableMeshIDs[slot.index];
+    return (uint64_t(1) << 63) | ((meshID & 0x7FFFFFFF) << 32) | slot.index;
+}
+
+RenderCollector::InstanceSlot* RenderCollector::findSlot(TransformDataStorage::HandleID handle) {
+    if (handle.index >= instanceSlots.size()) return nullptr;
+    InstanceSlot& slot = instanceSlots[handle.index];
+    if (slot.set == InstanceSet::None || slot.generation != handle.generation) return nullptr;
+    return &slot;
+}
+
+void RenderCollector::setSlot(TransformDataStorage::HandleID handle, InstanceSet set, uint32_t index) {
+    if (!handle.isValid()) return;
+    if (handle.index >= instanceSlots.size()) {
+        instanceSlots.resize(handle.index + 1);
     }
+    instanceSlots[handle.index] = InstanceSlot{handle.generation, index, set};
 }
@@ -2,9 +2,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
 // Vertex shader with SSBO-based rendering
 // Uses material ID and matrix ID to lookup data from SSBOs
+// Per-instance attributes start at each indirect command's baseInstance, so instances of one
+// mesh read their IDs from that mesh's slice of the ID streams
 const char* vertexShaderSource = R"(
 #version 430 core
 layout (location = 0) in vec3 aPos;
@@ -69,19 +73,26 @@ void RenderSystem::shutdown() {
         // Clean up using smart pointers (automatic)
         staticVAO.reset();
         dynamicVAO.reset();
-        vertexVBO.reset();
+        meshPool.reset();
         staticMaterialIDVBO.reset();
         staticMatrixIDVBO.reset();
         staticMaterialSSBO.reset();
         staticMatrixSSBO.reset();
+        staticCommandBuffer.reset();
         
-        dynamicMaterialIDVBO.reset();
-        dynamicMatrixIDVBO.reset();
+        dynamicStream.reset();
         dynamicMaterialSSBO.reset();
-        dynamicMatrixSSBO.reset();
         
         shaderProgram.reset();
         glInitialized = false;
+        staticDataUploaded = false;
+        staticDrawOrderDirty = true;
+        staticSlotCount = 0;
+        staticBuckets.clear();
+        staticSlotMeshes.clear();
+        staticSlotMaterials.clear();
+        staticDrawPositions.clear();
+        staticDrawSlots.clear();
     }
     std::cout << "[RenderSystem] Shutdown complete." << std::endl;
 }
@@ -98,44 +109,38 @@ void RenderSystem::initializeGL() {
         return;
     }
 
-    // Rectangle vertices from -0.5,-0.5 to +0.5,+0.5 (two triangles)
-    std::vector<float> vertices = {
-        // First triangle
-         0.5f,  0.5f, 0.0f,  // top right
-         0.5f, -0.5f, 0.0f,  // bottom right
-        -0.5f,  0.5f, 0.0f,  // top left
-        // Second triangle
-         0.5f, -0.5f, 0.0f,  // bottom right
-        -0.5f, -0.5f, 0.0f,  // bottom left
-        -0.5f,  0.5f, 0.0f   // top left
-    };
-
-    // Setup vertex buffer (position data) using VBO class - shared between static and dynamic
-    vertexVBO = std::make_unique<VBO<float>>(GL_STATIC_DRAW);
-    vertexVBO->initialize(vertices.size());
-    vertexVBO->uploadData(vertices);
+    // Shared mesh pool (positions + indices of every mesh) - shared between static and dynamic
+    // The unit quad goes in first so that it is DEFAULT_MESH
+    meshPool = std::make_unique<MeshPool>();
+    meshPool->initialize();
+    meshPool->registerMesh(Mesh::createQuad());
     
     // Initialize static resources (GL_STATIC_DRAW)
     staticMaterialIDVBO = std::make_unique<InstanceVBO<unsigned int>>(1, GL_STATIC_DRAW);
     staticMatrixIDVBO = std::make_unique<InstanceVBO<unsigned int>>(2, GL_STATIC_DRAW);
     staticMaterialSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(0, GL_STATIC_DRAW);
     staticMatrixSSBO = std::make_unique<SSBOBuffer<glm::mat4>>(1, GL_STATIC_DRAW);
+    staticCommandBuffer = std::make_unique<VBO<DrawElementsIndirectCommand>>(GL_STATIC_DRAW);
     
     staticMaterialIDVBO->initialize(100);
     staticMatrixIDVBO->initialize(100);
     staticMaterialSSBO->initialize(100);
     staticMatrixSSBO->initialize(100);
+    staticCommandBuffer->initialize(16);
     
-    // Initialize dynamic resources (GL_DYNAMIC_DRAW)
-    dynamicMaterialIDVBO = std::make_unique<InstanceVBO<unsigned int>>(1, GL_DYNAMIC_DRAW);
-    dynamicMatrixIDVBO = std::make_unique<InstanceVBO<unsigned int>>(2, GL_DYNAMIC_DRAW);
+    // Initialize dynamic resources (streaming ring, triple buffered)
+    dynamicStream = std::make_unique<StreamingBuffer>(100 * (sizeof(glm::mat4) + 2 * sizeof(unsigned int)) +
+                                                      StreamingBuffer::REGION_ALIGNMENT, 3);
     dynamicMaterialSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(0, GL_DYNAMIC_DRAW);
-    dynamicMatrixSSBO = std::make_unique<SSBOBuffer<glm::mat4>>(1, GL_DYNAMIC_DRAW);
     
-    dynamicMaterialIDVBO->initialize(100);
-    dynamicMatrixIDVBO->initialize(100);
+    dynamicStream->initialize();
     dynamicMaterialSSBO->initialize(100);
-    dynamicMatrixSSBO->initialize(100);
+
+    // SSBO ranges must start at a multiple of this
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssboOffsetAlignment);
+    if (ssboOffsetAlignment <= 0) {
+        ssboOffsetAlignment = 256;
+    }
 
     // ===== CREATE STATIC VAO with ARB_vertex_attrib_binding =====
     staticVAO = std::make_unique<VAO>();
@@ -153,7 +158,9 @@ void RenderSystem::initializeGL() {
     staticVAO->setupIntegerAttribute(2, 2, 1);  // attribute 2 -> binding 2
     
     // Bind buffers to binding points (ARB_vertex_attrib_binding)
-    staticVAO->bindVertexBuffer(0, vertexVBO->getBufferID(), 0, 3 * sizeof(float));  // Binding 0: position
+    // The pool buffers grow in place, so they are attached once
+    staticVAO->bindVertexBuffer(0, meshPool->getVertexBufferID(), 0, sizeof(glm::vec3));  // Binding 0: position
+    staticVAO->bindElementBuffer(meshPool->getIndexBufferID());
     staticVAO->bindVertexBuffer(1, staticMaterialIDVBO->getBufferID(), 0, sizeof(unsigned int));  // Binding 1: materialID
     staticVAO->bindVertexBuffer(2, staticMatrixIDVBO->getBufferID(), 0, sizeof(unsigned int));  // Binding 2: matrixID
     
@@ -173,9 +180,9 @@ void RenderSystem::initializeGL() {
     dynamicVAO->setupIntegerAttribute(2, 2, 1);  // attribute 2 -> binding 2
     
     // Bind buffers to binding points (dynamic buffers)
-    dynamicVAO->bindVertexBuffer(0, vertexVBO->getBufferID(), 0, 3 * sizeof(float));  // Binding 0: position (shared)
-    dynamicVAO->bindVertexBuffer(1, dynamicMaterialIDVBO->getBufferID(), 0, sizeof(unsigned int));  // Binding 1: materialID
-    dynamicVAO->bindVertexBuffer(2, dynamicMatrixIDVBO->getBufferID(), 0, sizeof(unsigned int));  // Binding 2: matrixID
+    // Bindings 1 and 2 (materialID, matrixID) point into dynamicStream - rebound each frame
+    dynamicVAO->bindVertexBuffer(0, meshPool->getVertexBufferID(), 0, sizeof(glm::vec3));  // Binding 0: position (shared)
+    dynamicVAO->bindElementBuffer(meshPool->getIndexBufferID());
     
     // Set divisors
     dynamicVAO->setBindingDivisor(0, 0);  // Position: per-vertex
@@ -194,82 +201,326 @@ void RenderSystem::initializeGL() {
     std::cout << "[RenderSystem] Dual VAO architecture with ARB_vertex_attrib_binding initialization complete." << std::endl;
 }
 
+MeshPool::MeshID RenderSystem::registerMesh(const MeshPtr& mesh) {
+    if (!glInitialized || !mesh) return DEFAULT_MESH;
+
+    MeshPool::MeshID id = meshPool->registerMesh(mesh);
+    return id == MeshPool::INVALID_MESH ? DEFAULT_MESH : id;
+}
+
+glm::mat4* RenderSystem::mapDynamicMatrices(size_t count) {
+    mappedDynamicCount = 0;
+    dynamicMatrixSource = 0;
+    if (!glInitialized || count == 0) return nullptr;
+
+    // Reserve the whole frame (matrices, both ID streams, commands) so later allocations cannot fail
+    const size_t alignment = static_cast<size_t>(ssboOffsetAlignment);
+    dynamicStream->beginFrame(count * (sizeof(glm::mat4) + 2 * sizeof(unsigned int)) +
+                              meshPool->getMeshCount() * sizeof(DrawElementsIndirectCommand) +
+                              alignment + 2 * sizeof(unsigned int));
+
+    glm::mat4* matrices = dynamicStream->allocate<glm::mat4>(count, alignment, dynamicMatrixOffset);
+    if (matrices) {
+        mappedDynamicCount = count;
+    }
+    return matrices;
+}
+
+unsigned int* RenderSystem::mapDynamicMatrixIDs(size_t count, GLuint worldMatrixSSBO) {
+    mappedDynamicCount = 0;
+    dynamicMatrixSource = 0;
+    if (!glInitialized || count == 0 || worldMatrixSSBO == 0) return nullptr;
+
+    // Reserve the whole frame (both ID streams, commands) so later allocations cannot fail
+    // The IDs are staged here and streamed by renderBatch() once the draw order is known
+    dynamicStream->beginFrame(count * 2 * sizeof(unsigned int) +
+                              meshPool->getMeshCount() * sizeof(DrawElementsIndirectCommand) +
+                              2 * sizeof(unsigned int));
+
+    dynamicMatrixIDs.resize(count);
+    mappedDynamicCount = count;
+    dynamicMatrixSource = worldMatrixSSBO;
+    return dynamicMatrixIDs.data();
+}
+
+void RenderSystem::buildDrawOrder(const std::vector<unsigned int>& meshIDs, size_t count) {
+    const size_t meshCount = meshPool->getMeshCount();
+    auto meshOf = [&](size_t instance) -> uint32_t {
+        return meshIDs[instance] < meshCount ? meshIDs[instance] : DEFAULT_MESH;
+    };
+
+    // Counting sort by mesh: instance counts, then each mesh's first slot
+    meshFirstSlots.assign(meshCount, 0);
+    for (size_t i = 0; i < count; ++i) {
+        ++meshFirstSlots[meshOf(i)];
+    }
+
+    drawCommands.clear();
+    uint32_t slot = 0;
+    for (size_t mesh = 0; mesh < meshCount; ++mesh) {
+        uint32_t instances = meshFirstSlots[mesh];
+        meshFirstSlots[mesh] = slot;
+        if (instances == 0) continue;
+
+        const MeshPool::MeshRange& range = meshPool->getRange(static_cast<MeshPool::MeshID>(mesh));
+        drawCommands.push_back({range.indexCount, instances, range.firstIndex, range.baseVertex, slot});
+        slot += instances;
+    }
+
+    // Stable - instances of one mesh keep their relative order
+    drawOrder.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        drawOrder[meshFirstSlots[meshOf(i)]++] = static_cast<uint32_t>(i);
+    }
+}
+
 void RenderSystem::renderBatch(const std::vector<glm::mat4>& staticMatrices,
                                 const std::vector<glm::vec4>& staticMaterials,
                                 const std::vector<unsigned int>& staticMaterialIDs,
-                                const std::vector<glm::mat4>& dynamicMatrices,
+                                const std::vector<unsigned int>& staticMeshIDs,
                                 const std::vector<glm::vec4>& dynamicMaterials,
-                                const std::vector<unsigned int>& dynamicMaterialIDs) {
+                                const std::vector<unsigned int>& dynamicMaterialIDs,
+                                const std::vector<unsigned int>& dynamicMeshIDs) {
     if (!glInitialized) return;
+
+    size_t dynamicCount = mappedDynamicCount;
+    mappedDynamicCount = 0;
     
     size_t staticCount = staticMatrices.size();
-    size_t dynamicCount = dynamicMatrices.size();
     
-    if (staticCount != staticMaterialIDs.size() || dynamicCount != dynamicMaterialIDs.size()) {
+    if (staticCount != staticMaterialIDs.size() || staticCount != staticMeshIDs.size() ||
+        dynamicMaterialIDs.size() != dynamicMeshIDs.size()) {
         std::cerr << "[RenderSystem] Error: Size mismatch in render batch data" << std::endl;
         return;
     }
+    if (dynamicCount != dynamicMaterialIDs.size()) {
+        // Matrices were not mapped for these instances - skip them, still draw the static set
+        std::cerr << "[RenderSystem] Error: " << dynamicMaterialIDs.size() << " dynamic instances but "
+                  << dynamicCount << " mapped matrices" << std::endl;
+        dynamicCount = 0;
+    }
     
     shaderProgram->use();
     
+    // Upload static data ONLY ONCE (GL_STATIC_DRAW optimization), again after markStaticDataDirty()
+    // Done even for an empty set so later addStaticInstance() calls have a base to patch
+    if (!staticDataUploaded) {
+        // Upload static data using helper classes (automatic resizing)
+        staticMaterialSSBO->uploadData(staticMaterials);
+        staticMatrixSSBO->uploadData(staticMatrices);
+
+        staticDataUploaded = true;
+        staticDrawOrderDirty = true;
+        staticSlotCount = staticCount;
+        std::cout << "[RenderSystem] Static data uploaded (GL_STATIC_DRAW): "
+                  << staticCount << " instances, "
+                  << staticMaterials.size() << " materials" << std::endl;
+    }
+
+    // Matrices of instances migrated since the last frame (addStaticInstance/removeStaticInstance)
+    staticMatrixSSBO->flush();
+
+    // Static instances grouped by mesh: matrix IDs are slots (matrices stay where they are),
+    // material IDs follow the same order - regrouped only after a full upload or when a
+    // migration did not fit its mesh's bucket (otherwise patched entry by entry)
+    if (staticDrawOrderDirty || staticSlotMeshes.size() != staticCount) {
+        rebuildStaticLayout(staticMaterialIDs, staticMeshIDs, staticCount);
+        staticDrawOrderDirty = false;
+    }
+
     // ===== RENDER STATIC OBJECTS using staticVAO =====
-    if (staticCount > 0 && !staticMaterials.empty()) {
-        // Upload static data ONLY ONCE (GL_STATIC_DRAW optimization)
-        if (!staticDataUploaded) {
-            // Upload static data using helper classes (automatic resizing)
-            staticMaterialSSBO->uploadData(staticMaterials);
-            staticMatrixSSBO->uploadData(staticMatrices);
-            staticMaterialIDVBO->uploadData(staticMaterialIDs);
-            
-            // Build static matrix IDs (1:1 mapping)
-            std::vector<unsigned int> staticMatrixIDs_data;
-            staticMatrixIDs_data.reserve(staticCount);
-            for (size_t i = 0; i < staticCount; ++i) {
-                staticMatrixIDs_data.push_back(static_cast<unsigned int>(i));
-            }
-            staticMatrixIDVBO->uploadData(staticMatrixIDs_data);
-            
-            staticDataUploaded = true;
-            std::cout << "[RenderSystem] Static data uploaded once (GL_STATIC_DRAW): " 
-                      << staticCount << " instances, " 
-                      << staticMaterials.size() << " materials" << std::endl;
-        }
-        
+    if (staticCount > 0 && !staticBuckets.empty() && !staticMaterials.empty()) {
         // Bind static resources using VAO class
         staticVAO->bind();
         staticMaterialSSBO->bind();
         staticMatrixSSBO->bind();
+        staticCommandBuffer->bind(GL_DRAW_INDIRECT_BUFFER);
         
-        // Draw static instances
-        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(staticCount));
+        // Draw static instances (one command per mesh)
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                    static_cast<GLsizei>(staticBuckets.size()), 0);
     }
     
     // ===== RENDER DYNAMIC OBJECTS using dynamicVAO =====
     if (dynamicCount > 0 && !dynamicMaterials.empty()) {
-        // Upload dynamic data using helper classes (automatic resizing, every frame)
+        // Matrices are already in place - written through mapDynamicMatrices() or computed on the GPU
         dynamicMaterialSSBO->uploadData(dynamicMaterials);
-        dynamicMatrixSSBO->uploadData(dynamicMatrices);
-        dynamicMaterialIDVBO->uploadData(dynamicMaterialIDs);
-        
-        // Build dynamic matrix IDs (1:1 mapping)
-        std::vector<unsigned int> dynamicMatrixIDs_data;
-        dynamicMatrixIDs_data.reserve(dynamicCount);
-        for (size_t i = 0; i < dynamicCount; ++i) {
-            dynamicMatrixIDs_data.push_back(static_cast<unsigned int>(i));
+        buildDrawOrder(dynamicMeshIDs, dynamicCount);
+
+        // Material IDs, matrix IDs and commands go straight into this frame's region, in draw order
+        // Streamed matrices are indexed by instance; GPU-driven matrix IDs were staged by the caller
+        GLintptr materialIDOffset = 0;
+        GLintptr matrixIDOffset = 0;
+        GLintptr commandOffset = 0;
+        unsigned int* materialIDs = dynamicStream->allocate<unsigned int>(dynamicCount, sizeof(unsigned int), materialIDOffset);
+        unsigned int* matrixIDs = dynamicStream->allocate<unsigned int>(dynamicCount, sizeof(unsigned int), matrixIDOffset);
+        auto* commands = dynamicStream->allocate<DrawElementsIndirectCommand>(drawCommands.size(), sizeof(GLuint), commandOffset);
+        if (materialIDs && matrixIDs && commands) {
+            const bool gpuMatrices = dynamicMatrixSource != 0;
+            for (size_t i = 0; i < dynamicCount; ++i) {
+                uint32_t instance = drawOrder[i];
+                materialIDs[i] = dynamicMaterialIDs[instance];
+                matrixIDs[i] = gpuMatrices ? dynamicMatrixIDs[instance] : instance;
+            }
+            std::memcpy(commands, drawCommands.data(), drawCommands.size() * sizeof(DrawElementsIndirectCommand));
+
+            // Bind dynamic resources using VAO class (ID streams and matrices by offset)
+            dynamicVAO->bind();
+            dynamicVAO->bindVertexBuffer(1, dynamicStream->getID(), materialIDOffset, sizeof(unsigned int));
+            dynamicVAO->bindVertexBuffer(2, dynamicStream->getID(), matrixIDOffset, sizeof(unsigned int));
+            dynamicMaterialSSBO->bind();
+            if (gpuMatrices) {
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, dynamicMatrixSource);
+            } else {
+                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, dynamicStream->getID(),
+                                  dynamicMatrixOffset, dynamicCount * sizeof(glm::mat4));
+            }
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, dynamicStream->getID());
+
+            // Draw dynamic instances (one command per mesh)
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(commandOffset),
+                                        static_cast<GLsizei>(drawCommands.size()), 0);
         }
-        dynamicMatrixIDVBO->uploadData(dynamicMatrixIDs_data);
-        
-        // Bind dynamic resources using VAO class
-        dynamicVAO->bind();
-        dynamicMaterialSSBO->bind();
-        dynamicMatrixSSBO->bind();
-        
-        // Draw dynamic instances
-        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(dynamicCount));
     }
+    // Fence this frame's region behind the draw (no-op if nothing was streamed)
+    dynamicStream->endFrame();
     
     VAO::unbind();
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void RenderSystem::rebuildStaticLayout(const std::vector<unsigned int>& materialIDs,
+                                       const std::vector<unsigned int>& meshIDs, size_t count) {
+    const size_t meshCount = meshPool->getMeshCount();
+
+    // Instances per mesh, then the buckets back to back in mesh ID order with a quarter
+    // (at least STATIC_BUCKET_SLACK entries) to spare
+    staticBuckets.assign(meshCount, StaticBucket{});
+    staticSlotMeshes.resize(count);
+    staticSlotMaterials.assign(materialIDs.begin(), materialIDs.begin() + count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t mesh = meshIDs[i] < meshCount ? meshIDs[i] : DEFAULT_MESH;
+        staticSlotMeshes[i] = mesh;
+        ++staticBuckets[mesh].count;
+    }
+    uint32_t base = 0;
+    meshFirstSlots.resize(meshCount);
+    for (size_t mesh = 0; mesh < meshCount; ++mesh) {
+        StaticBucket& bucket = staticBuckets[mesh];
+        bucket.base = base;
+        bucket.capacity = bucket.count + std::max<uint32_t>(bucket.count / 4, STATIC_BUCKET_SLACK);
+        meshFirstSlots[mesh] = base;
+        base += bucket.capacity;
+    }
+
+    // Stable within a mesh; spare entries are never drawn
+    staticDrawSlots.assign(base, 0);
+    staticDrawPositions.resize(count);
+    std::vector<unsigned int> streamMaterialIDs(base, 0);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t position = meshFirstSlots[staticSlotMeshes[i]]++;
+        staticDrawSlots[position] = static_cast<uint32_t>(i);
+        staticDrawPositions[i] = position;
+        streamMaterialIDs[position] = staticSlotMaterials[i];
+    }
+    staticMaterialIDVBO->uploadData(streamMaterialIDs);
+    staticMatrixIDVBO->uploadData(staticDrawSlots);
+
+    // One command per registered mesh (empty buckets draw nothing), so a migration patches
+    // exactly one command in place
+    drawCommands.clear();
+    for (size_t mesh = 0; mesh < meshCount; ++mesh) {
+        const MeshPool::MeshRange& range = meshPool->getRange(static_cast<MeshPool::MeshID>(mesh));
+        const StaticBucket& bucket = staticBuckets[mesh];
+        drawCommands.push_back({range.indexCount, bucket.count, range.firstIndex, range.baseVertex, bucket.base});
+    }
+    if (!drawCommands.empty()) {
+        staticCommandBuffer->uploadData(drawCommands);
+    }
+    staticSlotCount = count;
+}
+
+void RenderSystem::writeStaticDrawEntry(uint32_t position) {
+    const unsigned int slot = staticDrawSlots[position];
+    const unsigned int materialID = staticSlotMaterials[slot];
+    staticMatrixIDVBO->uploadRange(position, &slot, 1);
+    staticMaterialIDVBO->uploadRange(position, &materialID, 1);
+}
+
+void RenderSystem::writeStaticCommand(uint32_t mesh) {
+    const MeshPool::MeshRange& range = meshPool->getRange(mesh);
+    const StaticBucket& bucket = staticBuckets[mesh];
+    DrawElementsIndirectCommand command{range.indexCount, bucket.count, range.firstIndex, range.baseVertex, bucket.base};
+    staticCommandBuffer->uploadRange(mesh, &command, 1);
+}
+
+void RenderSystem::addStaticInstance(size_t index, const glm::mat4& matrix, unsigned int materialID, unsigned int meshID) {
+    if (!glInitialized || !staticDataUploaded) return;
+
+    // Sub-upload just this slot (the buffer grows in place if the set outgrew it)
+    // Matrices are staged and sent per coalesced range by renderBatch()
+    staticMatrixSSBO->write(index, matrix);
+    ++staticSlotCount;
+    if (staticDrawOrderDirty) return;  // The pending regroup covers it
+
+    // A mesh registered after the last regroup has no bucket yet; a full bucket cannot grow
+    // without moving its neighbours - both regroup in the next renderBatch()
+    const uint32_t mesh = meshID < meshPool->getMeshCount() ? meshID : DEFAULT_MESH;
+    if (index != staticSlotMeshes.size() || mesh >= staticBuckets.size() ||
+        staticBuckets[mesh].count == staticBuckets[mesh].capacity) {
+        staticDrawOrderDirty = true;
+        return;
+    }
+
+    StaticBucket& bucket = staticBuckets[mesh];
+    const uint32_t position = bucket.base + bucket.count++;
+    staticSlotMeshes.push_back(mesh);
+    staticSlotMaterials.push_back(materialID);
+    staticDrawPositions.push_back(position);
+    staticDrawSlots[position] = static_cast<uint32_t>(index);
+    writeStaticDrawEntry(position);
+    writeStaticCommand(mesh);
+}
+
+void RenderSystem::removeStaticInstance(size_t index, const glm::mat4& lastMatrix) {
+    if (!glInitialized || !staticDataUploaded || index >= staticSlotCount) return;
+
+    const size_t last = --staticSlotCount;
+    if (index != last) {
+        staticMatrixSSBO->write(index, lastMatrix);
+    }
+    if (staticDrawOrderDirty) return;  // The pending regroup covers it
+    if (last != staticSlotMeshes.size() - 1) {
+        staticDrawOrderDirty = true;
+        return;
+    }
+
+    // Close the gap in the removed instance's bucket with the bucket's last entry
+    const uint32_t mesh = staticSlotMeshes[index];
+    StaticBucket& bucket = staticBuckets[mesh];
+    const uint32_t position = staticDrawPositions[index];
+    const uint32_t lastPosition = bucket.base + --bucket.count;
+    if (position != lastPosition) {
+        const uint32_t movedSlot = staticDrawSlots[lastPosition];
+        staticDrawSlots[position] = movedSlot;
+        staticDrawPositions[movedSlot] = position;
+        writeStaticDrawEntry(position);
+    }
+    writeStaticCommand(mesh);
+
+    // The last slot takes over index - only its matrix ID entry changes
+    if (index != last) {
+        const uint32_t lastSlotPosition = staticDrawPositions[last];
+        staticSlotMeshes[index] = staticSlotMeshes[last];
+        staticSlotMaterials[index] = staticSlotMaterials[last];
+        staticDrawPositions[index] = lastSlotPosition;
+        staticDrawSlots[lastSlotPosition] = static_cast<uint32_t>(index);
+        writeStaticDrawEntry(lastSlotPosition);
+    }
+    staticSlotMeshes.pop_back();
+    staticSlotMaterials.pop_back();
+    staticDrawPositions.pop_back();
 }
 
 // Shader compilation/linking moved to shared ShaderProgram implementation
@@ -0,0 +1,135 @@
+#include "StreamingBuffer.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+StreamingBuffer::StreamingBuffer(size_t regionSize, uint32_t frameCount)
+    : regionSize(alignUp(std::max<size_t>(regionSize, REGION_ALIGNMENT), REGION_ALIGNMENT)),
+      frameCount(std::max<uint32_t>(frameCount, 1)),
+      fences(std::max<uint32_t>(frameCount, 1), nullptr) {
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    cleanup();
+}
+
+void StreamingBuffer::initialize() {
+    if (bufferID != 0) {
+        return;  // Already initialized
+    }
+    createStorage();
+}
+
+void StreamingBuffer::createStorage() {
+    // DSA: Immutable storage, mapped once for the lifetime of the buffer
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &bufferID);
+    glNamedBufferStorage(bufferID, regionSize * frameCount, nullptr, flags);
+    mappedPtr = static_cast<std::byte*>(glMapNamedBufferRange(bufferID, 0, regionSize * frameCount, flags));
+
+    if (!mappedPtr) {
+        std::cerr << "[StreamingBuffer] Error: Failed to map buffer persistently" << std::endl;
+    }
+
+    // The first beginFrame() advances to region 0
+    currentRegion = frameCount - 1;
+    frameOffset = 0;
+}
+
+void StreamingBuffer::beginFrame(size_t minBytes) {
+    if (bufferID == 0) {
+        initialize();
+    }
+    if (frameOpen) {
+        endFrame();  // Previous frame was never closed - fence it anyway
+    }
+
+    if (minBytes > regionSize) {
+        // Outgrown: the old buffer may still be read by frames in flight
+        size_t newRegionSize = alignUp(std::max(minBytes, regionSize * 2), REGION_ALIGNMENT);
+        std::cout << "[StreamingBuffer] Growing regions from " << regionSize << " to "
+                  << newRegionSize << " bytes" << std::endl;
+        cleanup();
+        regionSize = newRegionSize;
+        createStorage();
+    }
+
+    currentRegion = (currentRegion + 1) % frameCount;
+    waitForRegion(currentRegion);
+    frameOffset = 0;
+    frameOpen = true;
+}
+
+StreamingBuffer::Allocation StreamingBuffer::allocate(size_t bytes, size_t alignment) {
+    Allocation allocation;
+    if (!frameOpen || !mappedPtr) {
+        return allocation;
+    }
+
+    // Region starts are REGION_ALIGNMENT aligned, so aligning the in-region offset is enough
+    size_t offset = alignUp(frameOffset, alignment);
+    if (offset + bytes > regionSize) {
+        return allocation;  // Caller should have reserved with beginFrame(minBytes)
+    }
+    frameOffset = offset + bytes;
+
+    allocation.offset = static_cast<GLintptr>(currentRegion * regionSize + offset);
+    allocation.data = mappedPtr + allocation.offset;
+    allocation.size = bytes;
+    return allocation;
+}
+
+void StreamingBuffer::endFrame() {
+    if (!frameOpen) {
+        return;
+    }
+    fences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frameOpen = false;
+}
+
+void StreamingBuffer::waitForRegion(uint32_t region) {
+    GLsync fence = fences[region];
+    if (!fence) {
+        return;
+    }
+
+    // Poll first - only count a stall if the GPU really is behind
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++stallCount;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);  // 1s
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED) {
+        std::cerr << "[StreamingBuffer] Error: glClientWaitSync failed" << std::endl;
+    }
+
+    glDeleteSync(fence);
+    fences[region] = nullptr;
+}
+
+void StreamingBuffer::waitForAllRegions() {
+    for (uint32_t region = 0; region < frameCount; ++region) {
+        waitForRegion(region);
+    }
+}
+
+void StreamingBuffer::cleanup() {
+    if (bufferID != 0) {
+        waitForAllRegions();
+        if (mappedPtr) {
+            glUnmapNamedBuffer(bufferID);
+            mappedPtr = nullptr;
+        }
+        glDeleteBuffers(1, &bufferID);
+        bufferID = 0;
+    }
+    frameOffset = 0;
+    frameOpen = false;
+}
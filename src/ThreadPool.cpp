@@ -0,0 +1,82 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const RangeFunction& fn) {
+    if (count == 0) return;
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // Small jobs (or no workers) run inline - waking threads costs more than the work
+    if (workers.empty() || count <= grainSize) {
+        fn(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grainSize;
+        nextBegin.store(0, std::memory_order_relaxed);
+        activeWorkers.store(static_cast<uint32_t>(workers.size()), std::memory_order_relaxed);
+        ++jobGeneration;
+    }
+    wakeCondition.notify_all();
+
+    // Caller works too
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return activeWorkers.load(std::memory_order_acquire) == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::runChunks(uint32_t threadIndex) {
+    while (true) {
+        size_t begin = nextBegin.fetch_add(jobGrain, std::memory_order_relaxed);
+        if (begin >= jobCount) break;
+        size_t end = std::min(begin + jobGrain, jobCount);
+        (*job)(begin, end, threadIndex);
+    }
+}
+
+void ThreadPool::workerLoop(uint32_t threadIndex) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        runChunks(threadIndex);
+
+        if (activeWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            doneCondition.notify_one();
+        }
+    }
+}
@@ -2,6 +2,11 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <algorithm>
+
+namespace {
+    constexpr uint32_t ROOT_PARENT = 0xFFFFFFFF;
+}
 
 // Compute shader for flat hierarchy transform calculation
 static const char* computeShaderSource = R"(
@@ -31,19 +36,30 @@ layout(std430, binding = 4) buffer WorldMatrixBuffer {
     mat4 worldMatrices[];
 };
 
-// Convert quaternion to rotation matrix
+// Rows sorted by hierarchy level - level L occupies [levelOffset, levelOffset + levelSize)
+layout(std430, binding = 5) readonly buffer LevelRowBuffer {
+    uint levelRows[];
+};
+
+uniform uint levelOffset;  // One dispatch per level - parents were finished by earlier dispatches
+uniform uint levelSize;
+
+// The math below follows the CPU reference (TransformDataStorage / glm) operation for
+// operation; precise forbids contraction into fma, so results match bit for bit
+
+// Convert quaternion to rotation matrix (glm::mat4_cast)
 mat4 quatToMat4(vec4 q) {
-    float xx = q.x * q.x;
-    float yy = q.y * q.y;
-    float zz = q.z * q.z;
-    float xy = q.x * q.y;
-    float xz = q.x * q.z;
-    float yz = q.y * q.z;
-    float wx = q.w * q.x;
-    float wy = q.w * q.y;
-    float wz = q.w * q.z;
-    
-    mat4 m;
+    precise float xx = q.x * q.x;
+    precise float yy = q.y * q.y;
+    precise float zz = q.z * q.z;
+    precise float xy = q.x * q.y;
+    precise float xz = q.x * q.z;
+    precise float yz = q.y * q.z;
+    precise float wx = q.w * q.x;
+    precise float wy = q.w * q.y;
+    precise float wz = q.w * q.z;
+    
+    precise mat4 m;
     m[0][0] = 1.0 - 2.0 * (yy + zz);
     m[0][1] = 2.0 * (xy + wz);
     m[0][2] = 2.0 * (xz - wy);
@@ -68,33 +84,34 @@ mat4 quatToMat4(vec4 q) {
 }
 
 // Build TRS matrix
+// T * R * S only scales R's columns and places the translation (every other term is an
+// exact zero), so it is written out directly
 mat4 buildTRSMatrix(vec3 pos, vec4 rot, vec3 scale) {
-    // Scale matrix
-    mat4 S = mat4(1.0);
-    S[0][0] = scale.x;
-    S[1][1] = scale.y;
-    S[2][2] = scale.z;
-    
-    // Rotation matrix from quaternion
     mat4 R = quatToMat4(rot);
-    
-    // Translation matrix
-    mat4 T = mat4(1.0);
-    T[3][0] = pos.x;
-    T[3][1] = pos.y;
-    T[3][2] = pos.z;
-    
-    // TRS = T * R * S
-    return T * R * S;
+    precise mat4 m;
+    m[0] = R[0] * scale.x;
+    m[1] = R[1] * scale.y;
+    m[2] = R[2] * scale.z;
+    m[3] = vec4(pos, 1.0);
+    return m;
+}
+
+// parent * local with glm's summation order
+mat4 multiply(mat4 parent, mat4 local) {
+    precise mat4 m;
+    for (int c = 0; c < 4; ++c) {
+        m[c] = parent[0] * local[c][0] + parent[1] * local[c][1] +
+               parent[2] * local[c][2] + parent[3] * local[c][3];
+    }
+    return m;
 }
 
 void main() {
-    uint idx = gl_GlobalInvocationID.x;
-    
-    // Bounds check
-    if (idx >= positions.length()) {
+    // Bounds check against this dispatch's level
+    if (gl_GlobalInvocationID.x >= levelSize) {
         return;
     }
+    uint idx = levelRows[levelOffset + gl_GlobalInvocationID.x];
     
     // Build local TRS matrix
     vec3 pos = positions[idx].xyz;
@@ -110,13 +127,64 @@ void main() {
         worldMatrices[idx] = localMatrix;
     } else {
         // Has parent - world matrix = parent world * local matrix
-        // Note: This is a flat hierarchy, so parent must be computed first
-        // For true hierarchies, need multiple passes or reordering
-        worldMatrices[idx] = worldMatrices[parentIdx] * localMatrix;
+        // The parent is one level up, written by the previous dispatch
+        worldMatrices[idx] = multiply(worldMatrices[parentIdx], localMatrix);
     }
 }
 )";
 
+// Scatter pass: staged dirty rows -> TRS/parent buffers
+// Runs in GPU order behind the previous frame's level dispatches, so the CPU never has to
+// wait for them before the buffers are updated
+static const char* scatterShaderSource = R"(
+#version 430 core
+
+layout(local_size_x = 256) in;
+
+struct TransformUpload {
+    vec4 position;
+    vec4 rotation;
+    vec4 scale;
+    uint row;
+    uint parent;
+    uint padding0;
+    uint padding1;
+};
+
+layout(std430, binding = 0) writeonly buffer PositionBuffer {
+    vec4 positions[];
+};
+
+layout(std430, binding = 1) writeonly buffer RotationBuffer {
+    vec4 rotations[];
+};
+
+layout(std430, binding = 2) writeonly buffer ScaleBuffer {
+    vec4 scales[];
+};
+
+layout(std430, binding = 3) writeonly buffer ParentIndexBuffer {
+    uint parentIndices[];
+};
+
+layout(std430, binding = 6) readonly buffer UploadBuffer {
+    TransformUpload uploads[];
+};
+
+uniform uint uploadCount;
+
+void main() {
+    if (gl_GlobalInvocationID.x >= uploadCount) {
+        return;
+    }
+    TransformUpload upload = uploads[gl_GlobalInvocationID.x];
+    positions[upload.row] = upload.position;
+    rotations[upload.row] = upload.rotation;
+    scales[upload.row] = upload.scale;
+    parentIndices[upload.row] = upload.parent;
+}
+)";
+
 TransformComputeSystem::TransformComputeSystem(const std::string& name)
     : EntitySystem(name) {
 }
@@ -136,6 +204,8 @@ void TransformComputeSystem::update(float deltaTime) {
 
 void TransformComputeSystem::shutdown() {
     computeProgram.reset();
+    scatterProgram.reset();
+    uploadStream.reset();
     
     // SSBOs auto-cleaned by smart pointers
     positionSSBO.reset();
@@ -143,7 +213,17 @@ void TransformComputeSystem::shutdown() {
     scaleSSBO.reset();
     parentIndexSSBO.reset();
     worldMatrixSSBO.reset();
+    levelRowSSBO.reset();
     
+    parentRows.clear();
+    rowLevels.clear();
+    levelRows.clear();
+    levelRanges.clear();
+    dirtyRows.clear();
+    levelsDirty = true;
+    storageSynced = false;
+    identityRow = SIZE_MAX;
+    transformCount = 0;
     glInitialized = false;
 }
 
@@ -157,47 +237,247 @@ void TransformComputeSystem::initializeGL() {
         return;
     }
     
-    // Create SSBOs with persistent mapping for zero-copy updates
-    positionSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(0, GL_DYNAMIC_DRAW, true);
-    rotationSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(1, GL_DYNAMIC_DRAW, true);
-    scaleSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(2, GL_DYNAMIC_DRAW, true);
-    parentIndexSSBO = std::make_unique<SSBOBuffer<uint32_t>>(3, GL_DYNAMIC_DRAW, true);
+    scatterProgram = std::make_unique<ShaderProgram>();
+    if (!scatterProgram->createFromCompute(scatterShaderSource)) {
+        std::cerr << "[TransformComputeSystem] Failed to create scatter shader program" << std::endl;
+        return;
+    }
+
+    // TRS buffers live on the GPU: full uploads orphan them, incremental ones go through the
+    // streaming ring and the scatter pass - never written in place while a dispatch reads them
+    positionSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(0, GL_DYNAMIC_DRAW, false);
+    rotationSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(1, GL_DYNAMIC_DRAW, false);
+    scaleSSBO = std::make_unique<SSBOBuffer<glm::vec4>>(2, GL_DYNAMIC_DRAW, false);
+    parentIndexSSBO = std::make_unique<SSBOBuffer<uint32_t>>(3, GL_DYNAMIC_DRAW, false);
     worldMatrixSSBO = std::make_unique<SSBOBuffer<glm::mat4>>(4, GL_DYNAMIC_DRAW, false);
+    levelRowSSBO = std::make_unique<SSBOBuffer<uint32_t>>(5, GL_DYNAMIC_DRAW, false);
+
+    uploadStream = std::make_unique<StreamingBuffer>(1024 * sizeof(TransformUpload), 3);
+    uploadStream->initialize();
+
+    // SSBO ranges must start at a multiple of this
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssboOffsetAlignment);
+    if (ssboOffsetAlignment <= 0) {
+        ssboOffsetAlignment = 256;
+    }
     
     glInitialized = true;
     std::cout << "[TransformComputeSystem] GPU compute system initialized" << std::endl;
 }
 
+void TransformComputeSystem::syncFromStorage(TransformDataStorage& storage) {
+    if (!glInitialized) {
+        initializeGL();
+        if (!glInitialized) return;
+    }
+
+    const size_t count = storage.size();
+    auto positions = storage.getAllPositions();
+    auto rotations = storage.getAllRotations();
+    auto scales = storage.getAllScales();
+    auto parents = storage.getAllParents();
+    auto dirty = storage.getAllGpuDirty();
+
+    auto parentRowOf = [&](size_t row) {
+        TransformDataStorage::HandleID parent = parents[row];
+        return storage.isValid(parent) ? storage.getRow(parent) : ROOT_PARENT;
+    };
+
+    lastSyncedRowCount = 0;
+    const bool fullUpload = !storageSynced || syncedLayoutVersion != storage.getLayoutVersion() ||
+                            count < transformCount;
+    if (fullUpload) {
+        // Rows moved (or first sync): every row and every parent row index is rewritten
+        parentRows.resize(count);
+        glm::vec4* gpuPositions = positionSSBO->mapForWrite(count);
+        glm::vec4* gpuRotations = rotationSSBO->mapForWrite(count);
+        glm::vec4* gpuScales = scaleSSBO->mapForWrite(count);
+        uint32_t* gpuParents = parentIndexSSBO->mapForWrite(count);
+        if (gpuPositions && gpuRotations && gpuScales && gpuParents) {
+            for (size_t row = 0; row < count; ++row) {
+                const glm::quat& rotation = rotations[row];
+                gpuPositions[row] = glm::vec4(positions[row], 1.0f);
+                gpuRotations[row] = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+                gpuScales[row] = glm::vec4(scales[row], 1.0f);
+                gpuParents[row] = parentRows[row] = parentRowOf(row);
+                dirty[row] = 0;
+            }
+            lastSyncedRowCount = count;
+        }
+        positionSSBO->unmap();
+        rotationSSBO->unmap();
+        scaleSSBO->unmap();
+        parentIndexSSBO->unmap();
+        levelsDirty = true;
+    } else {
+        // Only rows whose TRS/parent changed (and rows created since the last sync)
+        parentRows.resize(count, ROOT_PARENT);
+        dirtyRows.clear();
+        for (size_t row = 0; row < count; ++row) {
+            if (dirty[row]) dirtyRows.push_back(static_cast<uint32_t>(row));
+        }
+
+        if (!dirtyRows.empty()) {
+            const size_t uploadCount = dirtyRows.size();
+            uploadStream->beginFrame(uploadCount * sizeof(TransformUpload) + ssboOffsetAlignment);
+            GLintptr uploadOffset = 0;
+            TransformUpload* uploads = uploadStream->allocate<TransformUpload>(uploadCount, ssboOffsetAlignment, uploadOffset);
+            if (uploads) {
+                for (size_t i = 0; i < uploadCount; ++i) {
+                    const uint32_t row = dirtyRows[i];
+                    const glm::quat& rotation = rotations[row];
+                    uint32_t parentRow = parentRowOf(row);
+                    if (row >= transformCount || parentRow != parentRows[row]) {
+                        parentRows[row] = parentRow;
+                        levelsDirty = true;
+                    }
+
+                    TransformUpload& upload = uploads[i];
+                    upload.position = glm::vec4(positions[row], 1.0f);
+                    upload.rotation = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+                    upload.scale = glm::vec4(scales[row], 1.0f);
+                    upload.row = row;
+                    upload.parent = parentRow;
+                    dirty[row] = 0;
+                }
+                lastSyncedRowCount = uploadCount;
+
+                reserveRows(count);
+                scatterProgram->use();
+                scatterProgram->setUniformUInt("uploadCount", static_cast<GLuint>(uploadCount));
+                positionSSBO->bind();
+                rotationSSBO->bind();
+                scaleSSBO->bind();
+                parentIndexSSBO->bind();
+                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 6, uploadStream->getID(),
+                                  uploadOffset, uploadCount * sizeof(TransformUpload));
+                glDispatchCompute(static_cast<GLuint>((uploadCount + 255) / 256), 1, 1);
+
+                // The level dispatches read what the scatter wrote
+                glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            }
+            // Fence the staged rows behind the scatter pass
+            uploadStream->endFrame();
+        }
+    }
+
+    transformCount = count;
+    storageSynced = true;
+    syncedLayoutVersion = storage.getLayoutVersion();
+    updateIdentityRow();
+    if (levelsDirty) {
+        updateLevels();
+    }
+}
+
 void TransformComputeSystem::uploadTransformData(const std::vector<glm::vec3>& positions,
                                                 const std::vector<glm::quat>& rotations,
                                                 const std::vector<glm::vec3>& scales,
                                                 const std::vector<uint32_t>& parentIndices) {
     if (!glInitialized) {
         initializeGL();
+        if (!glInitialized) return;
     }
     
     transformCount = positions.size();
     
-    // Convert vec3 to vec4 (padding for SSBO alignment)
-    std::vector<glm::vec4> posVec4(positions.size());
-    std::vector<glm::vec4> scaleVec4(scales.size());
-    std::vector<glm::vec4> rotVec4(rotations.size());
-    
-    for (size_t i = 0; i < positions.size(); ++i) {
-        posVec4[i] = glm::vec4(positions[i], 1.0f);
-        scaleVec4[i] = glm::vec4(scales[i], 1.0f);
-        rotVec4[i] = glm::vec4(rotations[i].x, rotations[i].y, rotations[i].z, rotations[i].w);
+    // Convert vec3 to vec4 (padding for SSBO alignment) straight into the mapped buffers
+    glm::vec4* gpuPositions = positionSSBO->mapForWrite(transformCount);
+    glm::vec4* gpuRotations = rotationSSBO->mapForWrite(transformCount);
+    glm::vec4* gpuScales = scaleSSBO->mapForWrite(transformCount);
+    if (gpuPositions && gpuRotations && gpuScales) {
+        for (size_t i = 0; i < transformCount; ++i) {
+            gpuPositions[i] = glm::vec4(positions[i], 1.0f);
+            gpuScales[i] = glm::vec4(scales[i], 1.0f);
+            gpuRotations[i] = glm::vec4(rotations[i].x, rotations[i].y, rotations[i].z, rotations[i].w);
+        }
     }
-    
-    // Upload to GPU (zero-copy with persistent mapping)
-    positionSSBO->uploadData(posVec4);
-    rotationSSBO->uploadData(rotVec4);
-    scaleSSBO->uploadData(scaleVec4);
+    positionSSBO->unmap();
+    rotationSSBO->unmap();
+    scaleSSBO->unmap();
     parentIndexSSBO->uploadData(parentIndices);
     
-    // Allocate output buffer
-    std::vector<glm::mat4> emptyMatrices(transformCount, glm::mat4(1.0f));
-    worldMatrixSSBO->uploadData(emptyMatrices);
+    // Output buffer only needs the room - every row is written by the dispatch
+    updateIdentityRow();
+
+    parentRows = parentIndices;
+    levelsDirty = true;
+    storageSynced = false;  // The next syncFromStorage() rewrites everything
+    updateLevels();
+}
+
+void TransformComputeSystem::reserveRows(size_t count) {
+    if (count <= positionSSBO->getCapacity()) {
+        return;
+    }
+    size_t capacity = std::max(count, positionSSBO->getCapacity() * 2);
+    positionSSBO->reserve(capacity);
+    rotationSSBO->reserve(capacity);
+    scaleSSBO->reserve(capacity);
+    parentIndexSSBO->reserve(capacity);
+}
+
+void TransformComputeSystem::updateIdentityRow() {
+    // Every other row is written by the dispatch - only the room is needed
+    worldMatrixSSBO->reserve(transformCount + 1);
+    if (identityRow != transformCount) {
+        const glm::mat4 identity(1.0f);
+        worldMatrixSSBO->uploadRange(transformCount, &identity, 1);
+        identityRow = transformCount;
+    }
+}
+
+void TransformComputeSystem::updateLevels() {
+    const size_t count = parentRows.size();
+    constexpr uint32_t UNKNOWN = 0xFFFFFFFF;
+    rowLevels.assign(count, UNKNOWN);
+    uint32_t levelCount = 0;
+
+    // Walk up to the first row with a known level, then assign levels on the way back down
+    std::vector<uint32_t> chain;
+    for (size_t row = 0; row < count; ++row) {
+        uint32_t current = static_cast<uint32_t>(row);
+        chain.clear();
+        while (current < count && rowLevels[current] == UNKNOWN && chain.size() <= count) {
+            chain.push_back(current);
+            current = parentRows[current];
+        }
+
+        // Root (or a parent outside the rows, or a cycle - treated as root)
+        uint32_t level = (current < count && rowLevels[current] != UNKNOWN) ? rowLevels[current] + 1 : 0;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            if (rowLevels[*it] == UNKNOWN) {
+                rowLevels[*it] = level++;
+            } else {
+                level = rowLevels[*it] + 1;
+            }
+        }
+    }
+    for (uint32_t level : rowLevels) {
+        levelCount = std::max(levelCount, level + 1);
+    }
+
+    // Counting sort: rows grouped by level, each level one contiguous range
+    levelRanges.assign(levelCount, LevelRange{});
+    for (uint32_t level : rowLevels) {
+        ++levelRanges[level].count;
+    }
+    uint32_t offset = 0;
+    for (LevelRange& range : levelRanges) {
+        range.offset = offset;
+        offset += range.count;
+    }
+    std::vector<uint32_t> cursor(levelCount);
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        cursor[level] = levelRanges[level].offset;
+    }
+    levelRows.resize(count);
+    for (size_t row = 0; row < count; ++row) {
+        levelRows[cursor[rowLevels[row]]++] = static_cast<uint32_t>(row);
+    }
+
+    levelRowSSBO->uploadData(levelRows);
+    levelsDirty = false;
 }
 
 void TransformComputeSystem::computeWorldMatrices() {
@@ -213,14 +493,84 @@ void TransformComputeSystem::computeWorldMatrices() {
     scaleSSBO->bind();
     parentIndexSSBO->bind();
     worldMatrixSSBO->bind();
+    levelRowSSBO->bind();
     
-    // Dispatch compute shader
+    // Dispatch compute shader once per hierarchy level, over just that level's rows
     // Work group size: 256 threads per group
-    GLuint numGroups = (transformCount + 255) / 256;
-    glDispatchCompute(numGroups, 1, 1);
-    
-    // Memory barrier to ensure writes are visible
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    for (const LevelRange& range : levelRanges) {
+        computeProgram->setUniformUInt("levelOffset", range.offset);
+        computeProgram->setUniformUInt("levelSize", range.count);
+        GLuint numGroups = (range.count + 255) / 256;
+        glDispatchCompute(numGroups, 1, 1);
+        
+        // Memory barrier to ensure writes are visible (next level, then the vertex shader)
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+}
+
+std::vector<glm::mat4> TransformComputeSystem::computeReferenceMatrices(const TransformDataStorage& storage) {
+    const size_t count = storage.size();
+    auto positions = storage.getAllPositions();
+    auto rotations = storage.getAllRotations();
+    auto scales = storage.getAllScales();
+    auto parents = storage.getAllParents();
+
+    // Same math as TransformDataStorage's CPU path, parents resolved first
+    std::vector<glm::mat4> matrices(count);
+    std::vector<uint8_t> done(count, 0);
+    std::vector<uint32_t> chain;
+    for (size_t row = 0; row < count; ++row) {
+        uint32_t current = static_cast<uint32_t>(row);
+        chain.clear();
+        while (current < count && !done[current] && chain.size() <= count) {
+            chain.push_back(current);
+            TransformDataStorage::HandleID parent = parents[current];
+            current = storage.isValid(parent) ? storage.getRow(parent) : ROOT_PARENT;
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            uint32_t r = *it;
+            if (done[r]) continue;
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), positions[r]) *
+                              glm::mat4_cast(rotations[r]) *
+                              glm::scale(glm::mat4(1.0f), scales[r]);
+            TransformDataStorage::HandleID parent = parents[r];
+            uint32_t parentRow = storage.isValid(parent) ? storage.getRow(parent) : ROOT_PARENT;
+            matrices[r] = (parentRow < count && done[parentRow]) ? matrices[parentRow] * local : local;
+            done[r] = 1;
+        }
+    }
+    return matrices;
+}
+
+size_t TransformComputeSystem::validateAgainstReference(const TransformDataStorage& storage) const {
+    std::vector<glm::mat4> gpu = readWorldMatrices();
+    std::vector<glm::mat4> reference = computeReferenceMatrices(storage);
+    if (gpu.size() != reference.size()) {
+        std::cerr << "[TransformComputeSystem] Validation: " << gpu.size() << " GPU rows, "
+                  << reference.size() << " storage rows (sync first)" << std::endl;
+        return std::max(gpu.size(), reference.size());
+    }
+
+    size_t mismatches = 0;
+    for (size_t row = 0; row < gpu.size(); ++row) {
+        if (gpu[row] != reference[row]) {
+            if (mismatches == 0) {
+                std::cerr << "[TransformComputeSystem] Validation: first mismatch at row " << row
+                          << " (level " << (row < rowLevels.size() ? rowLevels[row] : 0) << ")" << std::endl;
+            }
+            ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+std::vector<glm::mat4> TransformComputeSystem::readWorldMatrices() const {
+    std::vector<glm::mat4> matrices(transformCount);
+    if (glInitialized && transformCount > 0) {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glGetNamedBufferSubData(worldMatrixSSBO->getID(), 0, transformCount * sizeof(glm::mat4), matrices.data());
+    }
+    return matrices;
 }
 
 // Shader compilation/linking moved to shared ShaderProgram implementation
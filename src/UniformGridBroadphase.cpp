@@ -0,0 +1,208 @@
+#include "UniformGridBroadphase.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    constexpr size_t OBJECT_GRAIN = 2048;
+    constexpr size_t BUCKET_GRAIN = 1024;
+
+    // Run inline when no pool is given
+    void runRange(ThreadPool* pool, size_t count, size_t grain, const ThreadPool::RangeFunction& fn) {
+        if (pool) {
+            pool->parallelFor(count, grain, fn);
+        } else if (count > 0) {
+            fn(0, count, 0);
+        }
+    }
+
+    uint32_t nextPowerOfTwo(uint32_t value) {
+        uint32_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+}
+
+float UniformGridBroadphase::chooseCellSize(const CollisionDataStorage& storage) const {
+    const auto& minX = storage.getMinX();
+    const auto& minY = storage.getMinY();
+    const auto& maxX = storage.getMaxX();
+    const auto& maxY = storage.getMaxY();
+
+    // Sample the larger 2D side of up to 4096 boxes
+    constexpr size_t MAX_SAMPLES = 4096;
+    size_t stride = std::max<size_t>(1, objects.size() / MAX_SAMPLES);
+    std::vector<float> sizes;
+    sizes.reserve(std::min(objects.size(), MAX_SAMPLES + 1));
+    for (size_t i = 0; i < objects.size(); i += stride) {
+        uint32_t index = objects[i];
+        sizes.push_back(std::max(maxX[index] - minX[index], maxY[index] - minY[index]));
+    }
+    if (sizes.empty()) return 1.0f;
+
+    // 90th percentile: the typical large object spans at most 2x2 cells,
+    // while small objects still share cells with only a handful of neighbours
+    size_t nth = (sizes.size() * 9) / 10;
+    std::nth_element(sizes.begin(), sizes.begin() + nth, sizes.end());
+    float size = sizes[nth];
+    return size > 1e-6f ? size : 1.0f;
+}
+
+void UniformGridBroadphase::build(const CollisionDataStorage& storage, ThreadPool* pool) {
+    const auto& minX = storage.getMinX();
+    const auto& minY = storage.getMinY();
+    const auto& maxX = storage.getMaxX();
+    const auto& maxY = storage.getMaxY();
+    const auto& enabled = storage.getAllEnabledFlags();
+    const auto& mobility = storage.getAllMobility();
+    const auto& sleeping = storage.getAllSleepFlags();
+
+    // 1. Gather enabled awake movable slots (static and sleeping colliders are paired through the static tree)
+    objects.clear();
+    for (size_t i = 0; i < storage.getCount(); ++i) {
+        if (enabled[i] && mobility[i] != 0 && !sleeping[i]) objects.push_back(static_cast<uint32_t>(i));
+    }
+
+    cellSize = fixedCellSize > 0.0f ? fixedCellSize : chooseCellSize(storage);
+    inverseCellSize = 1.0f / cellSize;
+
+    // 2. Cell range per object (parallel)
+    const size_t objectCount = objects.size();
+    ranges.resize(objectCount);
+    entryOffsets.resize(objectCount + 1);
+    runRange(pool, objectCount, OBJECT_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t index = objects[i];
+            CellRange& r = ranges[i];
+            r.x0 = toCell(minX[index]);
+            r.y0 = toCell(minY[index]);
+            r.x1 = toCell(maxX[index]);
+            r.y1 = toCell(maxY[index]);
+            entryOffsets[i + 1] = static_cast<uint32_t>((r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1));
+        }
+    });
+
+    // 3. Prefix sum -> entry offsets per object
+    entryOffsets[0] = 0;
+    for (size_t i = 0; i < objectCount; ++i) {
+        entryOffsets[i + 1] += entryOffsets[i];
+    }
+    const uint32_t entryCount = entryOffsets[objectCount];
+
+    // Load factor <= 0.5 keeps unrelated cells from sharing buckets
+    bucketCount = nextPowerOfTwo(std::max<uint32_t>(64, entryCount * 2));
+    bucketStarts.assign(bucketCount + 1, 0);
+    unsortedEntries.resize(entryCount);
+    entryBuckets.resize(entryCount);
+    entries.resize(entryCount);
+
+    // 4. Emit entries in object order and histogram buckets (parallel)
+    runRange(pool, objectCount, OBJECT_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const CellRange& r = ranges[i];
+            uint32_t out = entryOffsets[i];
+            for (int32_t cy = r.y0; cy <= r.y1; ++cy) {
+                for (int32_t cx = r.x0; cx <= r.x1; ++cx) {
+                    uint32_t bucket = bucketOf(cx, cy);
+                    unsortedEntries[out] = {static_cast<uint32_t>(i), cx, cy};
+                    entryBuckets[out] = bucket;
+                    std::atomic_ref<uint32_t>(bucketStarts[bucket + 1]).fetch_add(1, std::memory_order_relaxed);
+                    ++out;
+                }
+            }
+        }
+    });
+
+    // 5. Prefix sum over buckets
+    for (uint32_t b = 0; b < bucketCount; ++b) {
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+    bucketCursors.assign(bucketStarts.begin(), bucketStarts.end() - 1);
+
+    // 6. Scatter into bucket order (parallel)
+    runRange(pool, entryCount, OBJECT_GRAIN * 4, [&](size_t begin, size_t end, uint32_t) {
+        for (size_t e = begin; e < end; ++e) {
+            uint32_t pos = std::atomic_ref<uint32_t>(bucketCursors[entryBuckets[e]])
+                               .fetch_add(1, std::memory_order_relaxed);
+            entries[pos] = unsortedEntries[e];
+        }
+    });
+
+    // 7. Scatter order within a bucket depends on thread timing - restore object order
+    //    so queries and pair output are deterministic (buckets hold a few entries)
+    if (pool) {
+        runRange(pool, bucketCount, BUCKET_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+            for (size_t b = begin; b < end; ++b) {
+                Entry* first = entries.data() + bucketStarts[b];
+                Entry* last = entries.data() + bucketStarts[b + 1];
+                for (Entry* it = first + 1; it < last; ++it) {
+                    Entry value = *it;
+                    Entry* hole = it;
+                    while (hole > first && (hole - 1)->slot > value.slot) {
+                        *hole = *(hole - 1);
+                        --hole;
+                    }
+                    *hole = value;
+                }
+            }
+        });
+    }
+}
+
+void UniformGridBroadphase::findPairs(const CollisionDataStorage& storage, std::vector<CollisionPair>& outPairs,
+                                      ThreadPool* pool) {
+    outPairs.clear();
+    if (bucketCount == 0 || entries.empty()) return;
+
+    // One output buffer per chunk, concatenated in chunk order
+    size_t chunkCount = ThreadPool::getChunkCount(bucketCount, BUCKET_GRAIN);
+    if (chunkPairs.size() < chunkCount) {
+        chunkPairs.resize(chunkCount);
+    }
+    for (auto& chunk : chunkPairs) {
+        chunk.clear();
+    }
+
+    const auto& layers = storage.getAllCollisionLayers();
+    const auto& masks = storage.getAllCollisionMasks();
+
+    runRange(pool, bucketCount, BUCKET_GRAIN, [&](size_t begin, size_t end, uint32_t) {
+        std::vector<CollisionPair>& local = chunkPairs[begin / BUCKET_GRAIN];
+
+        for (size_t b = begin; b < end; ++b) {
+            uint32_t first = bucketStarts[b];
+            uint32_t last = bucketStarts[b + 1];
+            for (uint32_t i = first; i < last; ++i) {
+                const Entry& ei = entries[i];
+                const CellRange& ri = ranges[ei.slot];
+                uint32_t a = objects[ei.slot];
+
+                // Bucket mates passing the cell tests go to the SIMD kernel 8 at a time
+                // (bounds overlap + layer/mask filter)
+                storage.batchOverlaps(storage.getBounds(a), layers[a], masks[a],
+                    [&](auto&& push) {
+                        for (uint32_t j = i + 1; j < last; ++j) {
+                            const Entry& ej = entries[j];
+                            if (ej.cellX != ei.cellX || ej.cellY != ei.cellY) continue;  // Hash collision
+
+                            // Only the cell holding the overlap's min corner reports the pair
+                            const CellRange& rj = ranges[ej.slot];
+                            if (std::max(ri.x0, rj.x0) != ei.cellX || std::max(ri.y0, rj.y0) != ei.cellY) continue;
+
+                            push(objects[ej.slot]);
+                        }
+                    },
+                    [&](uint32_t c) {
+                        local.push_back(a < c ? CollisionPair{a, c} : CollisionPair{c, a});
+                    });
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (size_t c = 0; c < chunkCount; ++c) total += chunkPairs[c].size();
+    outPairs.reserve(total);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        outPairs.insert(outPairs.end(), chunkPairs[c].begin(), chunkPairs[c].end());
+    }
+}
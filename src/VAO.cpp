@@ -67,6 +67,11 @@ void VAO::bindVertexBuffer(GLuint bindingPoint, GLuint bufferID,
     glBindVertexBuffer(bindingPoint, bufferID, offset, stride);
 }
 
+void VAO::bindElementBuffer(GLuint bufferID) {
+    // Recorded in the currently bound VAO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferID);
+}
+
 void VAO::setBindingDivisor(GLuint bindingPoint, GLuint divisor) {
     // Set divisor for instanced rendering (0 = per-vertex, 1+ = per-instance)
     glVertexBindingDivisor(bindingPoint, divisor);